@@ -0,0 +1,26 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/dsp/Biquad.cpp" "src/CMakeFiles/ODPedalDSP.dir/dsp/Biquad.cpp.o" "gcc" "src/CMakeFiles/ODPedalDSP.dir/dsp/Biquad.cpp.o.d"
+  "/root/repo/src/dsp/CabinetSim.cpp" "src/CMakeFiles/ODPedalDSP.dir/dsp/CabinetSim.cpp.o" "gcc" "src/CMakeFiles/ODPedalDSP.dir/dsp/CabinetSim.cpp.o.d"
+  "/root/repo/src/dsp/OverdriveDSP.cpp" "src/CMakeFiles/ODPedalDSP.dir/dsp/OverdriveDSP.cpp.o" "gcc" "src/CMakeFiles/ODPedalDSP.dir/dsp/OverdriveDSP.cpp.o.d"
+  "/root/repo/src/dsp/PerformanceTelemetry.cpp" "src/CMakeFiles/ODPedalDSP.dir/dsp/PerformanceTelemetry.cpp.o" "gcc" "src/CMakeFiles/ODPedalDSP.dir/dsp/PerformanceTelemetry.cpp.o.d"
+  "/root/repo/src/dsp/RealFFT.cpp" "src/CMakeFiles/ODPedalDSP.dir/dsp/RealFFT.cpp.o" "gcc" "src/CMakeFiles/ODPedalDSP.dir/dsp/RealFFT.cpp.o.d"
+  "/root/repo/src/dsp/RealtimeCheck.cpp" "src/CMakeFiles/ODPedalDSP.dir/dsp/RealtimeCheck.cpp.o" "gcc" "src/CMakeFiles/ODPedalDSP.dir/dsp/RealtimeCheck.cpp.o.d"
+  "/root/repo/src/dsp/Saturators.cpp" "src/CMakeFiles/ODPedalDSP.dir/dsp/Saturators.cpp.o" "gcc" "src/CMakeFiles/ODPedalDSP.dir/dsp/Saturators.cpp.o.d"
+  "/root/repo/src/dsp/TraceRecorder.cpp" "src/CMakeFiles/ODPedalDSP.dir/dsp/TraceRecorder.cpp.o" "gcc" "src/CMakeFiles/ODPedalDSP.dir/dsp/TraceRecorder.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
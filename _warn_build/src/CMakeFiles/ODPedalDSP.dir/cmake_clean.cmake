@@ -0,0 +1,25 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ODPedalDSP.dir/dsp/Biquad.cpp.o"
+  "CMakeFiles/ODPedalDSP.dir/dsp/Biquad.cpp.o.d"
+  "CMakeFiles/ODPedalDSP.dir/dsp/CabinetSim.cpp.o"
+  "CMakeFiles/ODPedalDSP.dir/dsp/CabinetSim.cpp.o.d"
+  "CMakeFiles/ODPedalDSP.dir/dsp/OverdriveDSP.cpp.o"
+  "CMakeFiles/ODPedalDSP.dir/dsp/OverdriveDSP.cpp.o.d"
+  "CMakeFiles/ODPedalDSP.dir/dsp/PerformanceTelemetry.cpp.o"
+  "CMakeFiles/ODPedalDSP.dir/dsp/PerformanceTelemetry.cpp.o.d"
+  "CMakeFiles/ODPedalDSP.dir/dsp/RealFFT.cpp.o"
+  "CMakeFiles/ODPedalDSP.dir/dsp/RealFFT.cpp.o.d"
+  "CMakeFiles/ODPedalDSP.dir/dsp/RealtimeCheck.cpp.o"
+  "CMakeFiles/ODPedalDSP.dir/dsp/RealtimeCheck.cpp.o.d"
+  "CMakeFiles/ODPedalDSP.dir/dsp/Saturators.cpp.o"
+  "CMakeFiles/ODPedalDSP.dir/dsp/Saturators.cpp.o.d"
+  "CMakeFiles/ODPedalDSP.dir/dsp/TraceRecorder.cpp.o"
+  "CMakeFiles/ODPedalDSP.dir/dsp/TraceRecorder.cpp.o.d"
+  "libODPedalDSP.a"
+  "libODPedalDSP.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ODPedalDSP.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/od_bench.dir/main.cpp.o"
+  "CMakeFiles/od_bench.dir/main.cpp.o.d"
+  "od_bench"
+  "od_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/od_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/tools/od_golden/ReferenceOverdrive.cpp" "tools/od_golden/CMakeFiles/od_golden.dir/ReferenceOverdrive.cpp.o" "gcc" "tools/od_golden/CMakeFiles/od_golden.dir/ReferenceOverdrive.cpp.o.d"
+  "/root/repo/tools/od_golden/main.cpp" "tools/od_golden/CMakeFiles/od_golden.dir/main.cpp.o" "gcc" "tools/od_golden/CMakeFiles/od_golden.dir/main.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_warn_build/src/CMakeFiles/ODPedalDSP.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
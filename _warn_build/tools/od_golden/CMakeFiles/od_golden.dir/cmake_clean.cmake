@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/od_golden.dir/ReferenceOverdrive.cpp.o"
+  "CMakeFiles/od_golden.dir/ReferenceOverdrive.cpp.o.d"
+  "CMakeFiles/od_golden.dir/main.cpp.o"
+  "CMakeFiles/od_golden.dir/main.cpp.o.d"
+  "od_golden"
+  "od_golden.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/od_golden.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
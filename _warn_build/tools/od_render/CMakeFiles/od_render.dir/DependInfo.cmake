@@ -0,0 +1,22 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/tools/od_render/MappedFile.cpp" "tools/od_render/CMakeFiles/od_render.dir/MappedFile.cpp.o" "gcc" "tools/od_render/CMakeFiles/od_render.dir/MappedFile.cpp.o.d"
+  "/root/repo/tools/od_render/WavIO.cpp" "tools/od_render/CMakeFiles/od_render.dir/WavIO.cpp.o" "gcc" "tools/od_render/CMakeFiles/od_render.dir/WavIO.cpp.o.d"
+  "/root/repo/tools/od_render/main.cpp" "tools/od_render/CMakeFiles/od_render.dir/main.cpp.o" "gcc" "tools/od_render/CMakeFiles/od_render.dir/main.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_warn_build/src/CMakeFiles/ODPedalDSP.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
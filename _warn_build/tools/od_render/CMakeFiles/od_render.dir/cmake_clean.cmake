@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/od_render.dir/MappedFile.cpp.o"
+  "CMakeFiles/od_render.dir/MappedFile.cpp.o.d"
+  "CMakeFiles/od_render.dir/WavIO.cpp.o"
+  "CMakeFiles/od_render.dir/WavIO.cpp.o.d"
+  "CMakeFiles/od_render.dir/main.cpp.o"
+  "CMakeFiles/od_render.dir/main.cpp.o.d"
+  "od_render"
+  "od_render.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/od_render.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/tools/od_rtcheck/RealtimeHooks.cpp" "tools/od_rtcheck/CMakeFiles/od_rtcheck.dir/RealtimeHooks.cpp.o" "gcc" "tools/od_rtcheck/CMakeFiles/od_rtcheck.dir/RealtimeHooks.cpp.o.d"
+  "/root/repo/tools/od_rtcheck/main.cpp" "tools/od_rtcheck/CMakeFiles/od_rtcheck.dir/main.cpp.o" "gcc" "tools/od_rtcheck/CMakeFiles/od_rtcheck.dir/main.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_warn_build/src/CMakeFiles/ODPedalDSP.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
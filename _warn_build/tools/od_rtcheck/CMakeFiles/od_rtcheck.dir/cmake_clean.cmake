@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/od_rtcheck.dir/RealtimeHooks.cpp.o"
+  "CMakeFiles/od_rtcheck.dir/RealtimeHooks.cpp.o.d"
+  "CMakeFiles/od_rtcheck.dir/main.cpp.o"
+  "CMakeFiles/od_rtcheck.dir/main.cpp.o.d"
+  "od_rtcheck"
+  "od_rtcheck.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/od_rtcheck.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
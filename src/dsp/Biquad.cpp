@@ -0,0 +1,171 @@
+# include "Biquad.h"
+
+// helper to build low-pass filter coefficients
+template <typename Sample>
+BiquadCoefficients<Sample> BiquadCoefficients<Sample>::makeLowPass(Sample sampleRate, Sample cutoffFreq, Sample Q)
+{
+    // biquad cookbook formulas
+    const Sample pi = static_cast<Sample>(3.14159265358979323846);
+    Sample w0 = Sample(2) * pi * cutoffFreq / sampleRate;
+    Sample sinW0 = std::sin(w0);
+    Sample cosW0 = std::cos(w0);
+    Sample alpha = sinW0 / (Sample(2) * Q);
+
+    // LPF formulas, normalized by a0
+    Sample a0 = Sample(1) + alpha;
+    BiquadCoefficients c;
+    c.b0 = ((Sample(1) - cosW0) / Sample(2)) / a0;
+    c.b1 = (Sample(1) - cosW0) / a0;
+    c.b2 = ((Sample(1) - cosW0) / Sample(2)) / a0;
+    c.a1 = (Sample(-2) * cosW0) / a0;
+    c.a2 = (Sample(1) - alpha) / a0;
+    return c;
+}
+
+// helper to build high-pass filter coefficients
+template <typename Sample>
+BiquadCoefficients<Sample> BiquadCoefficients<Sample>::makeHighPass(Sample sampleRate, Sample cutoffFreq, Sample Q)
+{
+    const Sample pi = static_cast<Sample>(3.14159265358979323846);
+    Sample w0 = Sample(2) * pi * cutoffFreq / sampleRate;
+    Sample sinW0 = std::sin(w0);
+    Sample cosW0 = std::cos(w0);
+    Sample alpha = sinW0 / (Sample(2) * Q);
+
+    // HPF formulas, normalized by a0
+    Sample a0 = Sample(1) + alpha;
+    BiquadCoefficients c;
+    c.b0 = ((Sample(1) + cosW0) / Sample(2)) / a0;
+    c.b1 = -(Sample(1) + cosW0) / a0;
+    c.b2 = ((Sample(1) + cosW0) / Sample(2)) / a0;
+    c.a1 = (Sample(-2) * cosW0) / a0;
+    c.a2 = (Sample(1) - alpha) / a0;
+    return c;
+}
+
+template struct BiquadCoefficients<float>;
+template struct BiquadCoefficients<double>;
+
+// state-space form of TDF-II: y = s1 + b0 x, s' = A s + B x with
+// A = [-a1 1; -a2 0] and B = [b1 - a1 b0; b2 - a2 b0]
+template <typename Sample>
+BiquadBlockForm BiquadBlockForm::make(const BiquadCoefficients<Sample>& coefficients)
+{
+    const double b0 = coefficients.b0, b1 = coefficients.b1, b2 = coefficients.b2;
+    const double a1 = coefficients.a1, a2 = coefficients.a2;
+
+    // impulse response h[m], h[0] = b0 and h[m] = first row of A^(m-1) B
+    double impulse[blockLength];
+    impulse[0] = b0;
+    double v1 = b1 - a1 * b0, v2 = b2 - a2 * b0;
+    for (int m = 1; m < blockLength; ++m)
+    {
+        impulse[m] = v1;
+        const double next1 = -a1 * v1 + v2;
+        v2 = -a2 * v1;
+        v1 = next1;
+    }
+
+    BiquadBlockForm form;
+    for (int j = 0; j < blockLength; ++j)
+        for (int k = 0; k < blockLength; ++k)
+            form.fromInput[j][k] = k >= j ? impulse[k - j] : 0.0;
+
+    // response to the starting state, first row of A^k
+    double r1 = 1.0, r2 = 0.0;
+    for (int k = 0; k < blockLength; ++k)
+    {
+        form.fromState1[k] = r1;
+        form.fromState2[k] = r2;
+        const double next1 = -a1 * r1 - a2 * r2;
+        r2 = r1;
+        r1 = next1;
+    }
+
+    form.b1 = b1;
+    form.b2 = b2;
+    form.a1 = a1;
+    form.a2 = a2;
+    return form;
+}
+
+template BiquadBlockForm BiquadBlockForm::make(const BiquadCoefficients<float>&);
+template BiquadBlockForm BiquadBlockForm::make(const BiquadCoefficients<double>&);
+
+// GCC and Clang on x86-64 ELF targets build the block-form kernel for AVX-512,
+// AVX2 and the SSE2 baseline, and the loader resolves it to the widest the CPU
+// supports; other compilers build the baseline only
+# if defined(__GNUC__) && defined(__x86_64__) && defined(__ELF__)
+    # define ODPEDAL_CPU_DISPATCH __attribute__((target_clones("avx512f", "avx2", "default")))
+    # define ODPEDAL_ALWAYS_INLINE __attribute__((always_inline)) inline
+# else
+    # define ODPEDAL_CPU_DISPATCH
+    # define ODPEDAL_ALWAYS_INLINE inline
+# endif
+
+namespace
+{
+    // inlined into every clone so each is compiled for its own instruction set
+    template <typename Sample>
+    ODPEDAL_ALWAYS_INLINE void runBlockForm(const BiquadBlockForm& form, Sample& state1, Sample& state2,
+                                            Sample* samples, int numSamples)
+    {
+        constexpr int length = BiquadBlockForm::blockLength;
+        const double b1 = form.b1, b2 = form.b2, a1 = form.a1, a2 = form.a2;
+        double s1 = state1, s2 = state2;
+
+        int i = 0;
+        for (; i + length <= numSamples; i += length)
+        {
+            Sample* block = samples + i;
+            double x[length];
+            for (int k = 0; k < length; ++k)
+                x[k] = static_cast<double>(block[k]);
+
+            // the input part does not depend on the state, so consecutive blocks overlap
+            alignas(64) double y[length];
+            for (int k = 0; k < length; ++k)
+                y[k] = form.fromInput[0][k] * x[0];
+            for (int j = 1; j < length; ++j)
+                for (int k = 0; k < length; ++k)
+                    y[k] += form.fromInput[j][k] * x[j];
+
+            for (int k = 0; k < length; ++k)
+                y[k] += form.fromState1[k] * s1 + form.fromState2[k] * s2;
+
+            // TDF-II state after the block, from its last two inputs and outputs
+            const double previous2 = b2 * x[length - 2] - a2 * y[length - 2];
+            s1 = b1 * x[length - 1] - a1 * y[length - 1] + previous2;
+            s2 = b2 * x[length - 1] - a2 * y[length - 1];
+
+            for (int k = 0; k < length; ++k)
+                block[k] = static_cast<Sample>(y[k]);
+        }
+
+        // remainder one sample at a time
+        const double b0 = form.fromInput[0][0];
+        for (; i < numSamples; ++i)
+        {
+            double input = samples[i];
+            double output = b0 * input + s1;
+            s1 = b1 * input - a1 * output + s2;
+            s2 = b2 * input - a2 * output;
+            samples[i] = static_cast<Sample>(output);
+        }
+
+        state1 = static_cast<Sample>(s1);
+        state2 = static_cast<Sample>(s2);
+    }
+}
+
+ODPEDAL_CPU_DISPATCH
+void processBiquadBlockForm(const BiquadBlockForm& form, float& s1, float& s2, float* samples, int numSamples)
+{
+    runBlockForm(form, s1, s2, samples, numSamples);
+}
+
+ODPEDAL_CPU_DISPATCH
+void processBiquadBlockForm(const BiquadBlockForm& form, double& s1, double& s2, double* samples, int numSamples)
+{
+    runBlockForm(form, s1, s2, samples, numSamples);
+}
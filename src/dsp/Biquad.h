@@ -0,0 +1,293 @@
+# pragma once
+
+# include <cmath>
+# include <array>
+# include <type_traits>
+
+// normalised biquad coefficients (a0 == 1), float and double are instantiated
+template <typename Sample = float>
+struct BiquadCoefficients
+{
+    Sample b0 = 1, b1 = 0, b2 = 0;
+    Sample a1 = 0, a2 = 0;
+
+    // RBJ cookbook designs, evaluated in Sample precision
+    static BiquadCoefficients makeLowPass(Sample sampleRate, Sample cutoffFreq, Sample Q);
+    static BiquadCoefficients makeHighPass(Sample sampleRate, Sample cutoffFreq, Sample Q);
+};
+
+// how a single channel runs its biquads: one sample after another, or in
+// look-ahead form with consecutive samples in SIMD lanes. both keep the same
+// TDF-II state, so a filter can switch between them at any block boundary
+enum class FilterStructure
+{
+    Serial,      // per-sample recursion, the reference rounding
+    LookAhead    // BiquadBlockForm, several times faster, runs in double so it rounds less
+};
+
+// look-ahead (block) form of one biquad for a single channel. the recursion is
+// unrolled blockLength samples ahead in state-space form, so a whole block of
+// outputs is a matrix product of the block's inputs and the state at its start:
+//   y[k] = fromState1[k] * s1 + fromState2[k] * s2 + sum over j <= k of h[k - j] * x[j]
+// every output of the block is one SIMD lane, and only the state handover
+// between blocks stays serial. with poles close to z = 1 the state terms
+// nearly cancel, so the form is double for both sample types; samples and
+// state are only rounded to Sample on the way out
+struct BiquadBlockForm
+{
+    static constexpr int blockLength = 8;
+
+    alignas(64) double fromInput[blockLength][blockLength] {};   // [j][k] = h[k - j], zero for j > k
+    alignas(64) double fromState1[blockLength] {};
+    alignas(64) double fromState2[blockLength] {};
+    double b1 = 0, b2 = 0, a1 = 0, a2 = 0;                         // to rebuild the state after a block
+
+    // derive the block form of a biquad, instantiated for float and double coefficients
+    template <typename Sample>
+    static BiquadBlockForm make(const BiquadCoefficients<Sample>& coefficients);
+};
+
+// run one TDF-II biquad over a single-channel buffer in its block form,
+// s1/s2 are the section's state and are updated. the kernel is built for
+// several instruction sets where the compiler supports it and the widest one
+// the CPU has is picked at load time
+void processBiquadBlockForm(const BiquadBlockForm& form, float& s1, float& s2, float* samples, int numSamples);
+void processBiquadBlockForm(const BiquadBlockForm& form, double& s1, double& s2, double* samples, int numSamples);
+
+// cascade of second-order sections in transposed direct form II.
+// coefficients are shared by NumLanes independent channels whose samples are
+// interleaved frame by frame (lane-major), so with NumLanes > 1 every step is a
+// fixed-width loop over the lanes. each section's coefficients and per-lane state
+// share one slot, and the slots are contiguous and cache-line aligned.
+// single-lane cascades also keep every section's look-ahead form, so a mono
+// channel still fills the SIMD registers with consecutive samples.
+template <int NumSections, int NumLanes = 1, typename Sample = float>
+class BiquadCascade
+{
+    public:
+        static_assert(NumSections > 0, "BiquadCascade needs at least one section");
+        static_assert(NumLanes > 0, "BiquadCascade needs at least one lane");
+
+        void setCoefficients(int section, const BiquadCoefficients<Sample>& coefficients)
+        {
+            Section& s = sections[section];
+            s.b0 = coefficients.b0;
+            s.b1 = coefficients.b1;
+            s.b2 = coefficients.b2;
+            s.a1 = coefficients.a1;
+            s.a2 = coefficients.a2;
+
+            if constexpr (NumLanes == 1)
+            {
+                blockForms[section] = BiquadBlockForm::make(coefficients);
+                blockFormStale[section] = false;
+            }
+        }
+
+        // the same with the look-ahead form built beforehand (single lane only),
+        // for coefficients designed off the audio thread
+        void setCoefficients(int section, const BiquadCoefficients<Sample>& coefficients, const BiquadBlockForm& form)
+        {
+            static_assert(NumLanes == 1, "only single-lane cascades keep look-ahead forms");
+
+            Section& s = sections[section];
+            s.b0 = coefficients.b0;
+            s.b1 = coefficients.b1;
+            s.b2 = coefficients.b2;
+            s.a1 = coefficients.a1;
+            s.a2 = coefficients.a2;
+
+            blockForms[section] = form;
+            blockFormStale[section] = false;
+        }
+
+        BiquadCoefficients<Sample> getCoefficients(int section) const
+        {
+            const Section& s = sections[section];
+            return BiquadCoefficients<Sample> { s.b0, s.b1, s.b2, s.a1, s.a2 };
+        }
+
+        // clear the filter state, coefficients are kept
+        void reset()
+        {
+            for (Section& s : sections)
+            {
+                for (int lane = 0; lane < NumLanes; ++lane)
+                {
+                    s.s1[lane] = 0;
+                    s.s2[lane] = 0;
+                }
+            }
+        }
+
+        // true when every state value of every lane is below threshold in magnitude
+        bool isQuiet(Sample threshold) const
+        {
+            bool quiet = true;
+            for (const Section& s : sections)
+            {
+                for (int lane = 0; lane < NumLanes; ++lane)
+                    quiet = quiet && std::abs(s.s1[lane]) < threshold && std::abs(s.s2[lane]) < threshold;
+            }
+            return quiet;
+        }
+
+        // one sample through every section (single lane only)
+        Sample processSample(Sample input)
+        {
+            static_assert(NumLanes == 1, "processSample is single-lane, use processBlock");
+
+            for (Section& s : sections)
+            {
+                Sample output = s.b0 * input + s.s1[0];
+                s.s1[0] = s.b1 * input - s.a1 * output + s.s2[0];
+                s.s2[0] = s.b2 * input - s.a2 * output;
+                input = output;
+            }
+
+            return input;
+        }
+
+        // whole buffer through every section, one tight loop per section
+        void processBlock(Sample* frames, int numFrames)
+        {
+            for (int section = 0; section < NumSections; ++section)
+                processSectionBlock(section, frames, numFrames);
+        }
+
+        // whole buffer through a single section
+        void processSectionBlock(int section, Sample* frames, int numFrames)
+        {
+            // coefficients and state live in registers for the duration of the loop
+            Section& s = sections[section];
+            const Sample b0 = s.b0, b1 = s.b1, b2 = s.b2, a1 = s.a1, a2 = s.a2;
+            Sample s1[NumLanes], s2[NumLanes];
+            for (int lane = 0; lane < NumLanes; ++lane)
+            {
+                s1[lane] = s.s1[lane];
+                s2[lane] = s.s2[lane];
+            }
+
+            for (int i = 0; i < numFrames; ++i)
+            {
+                Sample* frame = frames + i * NumLanes;
+                stepLanes(frame, s1, s2, b0, b1, b2, a1, a2);
+            }
+
+            for (int lane = 0; lane < NumLanes; ++lane)
+            {
+                s.s1[lane] = s1[lane];
+                s.s2[lane] = s2[lane];
+            }
+        }
+
+        // whole buffer through a single section in its look-ahead form (single lane
+        // only), the same filter as processSectionBlock() with different rounding
+        void processSectionBlockLookAhead(int section, Sample* frames, int numFrames)
+        {
+            static_assert(NumLanes == 1, "the look-ahead form is single-lane, lanes already fill the SIMD registers");
+
+            Section& s = sections[section];
+            if (blockFormStale[section])
+            {
+                blockForms[section] = BiquadBlockForm::make(getCoefficients(section));
+                blockFormStale[section] = false;
+            }
+
+            processBiquadBlockForm(blockForms[section], s.s1[0], s.s2[0], frames, numFrames);
+        }
+
+        // whole buffer through a single section while its coefficients move
+        // linearly to target; they land exactly on target at the last frame
+        void processSectionBlockRamped(int section, Sample* frames, int numFrames, const BiquadCoefficients<Sample>& target)
+        {
+            Section& s = sections[section];
+            Sample scale = numFrames > 0 ? Sample(1) / static_cast<Sample>(numFrames) : Sample(0);
+            Sample b0 = s.b0, b1 = s.b1, b2 = s.b2, a1 = s.a1, a2 = s.a2;
+            const Sample b0Step = (target.b0 - b0) * scale;
+            const Sample b1Step = (target.b1 - b1) * scale;
+            const Sample b2Step = (target.b2 - b2) * scale;
+            const Sample a1Step = (target.a1 - a1) * scale;
+            const Sample a2Step = (target.a2 - a2) * scale;
+            Sample s1[NumLanes], s2[NumLanes];
+            for (int lane = 0; lane < NumLanes; ++lane)
+            {
+                s1[lane] = s.s1[lane];
+                s2[lane] = s.s2[lane];
+            }
+
+            for (int i = 0; i < numFrames; ++i)
+            {
+                b0 += b0Step;
+                b1 += b1Step;
+                b2 += b2Step;
+                a1 += a1Step;
+                a2 += a2Step;
+
+                Sample* frame = frames + i * NumLanes;
+                stepLanes(frame, s1, s2, b0, b1, b2, a1, a2);
+            }
+
+            for (int lane = 0; lane < NumLanes; ++lane)
+            {
+                s.s1[lane] = s1[lane];
+                s.s2[lane] = s2[lane];
+            }
+
+            // ramps usually follow ramps, so the look-ahead form is only rebuilt
+            // once processSectionBlockLookAhead() needs it
+            s.b0 = target.b0;
+            s.b1 = target.b1;
+            s.b2 = target.b2;
+            s.a1 = target.a1;
+            s.a2 = target.a2;
+            if constexpr (NumLanes == 1)
+                blockFormStale[section] = true;
+        }
+
+    private:
+        struct alignas(32) Section
+        {
+            Sample b0 = 1, b1 = 0, b2 = 0;
+            Sample a1 = 0, a2 = 0;
+            Sample s1[NumLanes] = {};   // TDF-II state, one per lane
+            Sample s2[NumLanes] = {};
+        };
+
+        alignas(64) std::array<Section, NumSections> sections {};
+
+        // one frame of every lane through a section. each statement is its own
+        // loop over the lanes, which GCC turns into whole-register operations;
+        // a per-lane body with the same arithmetic stays scalar
+        static void stepLanes(Sample* frame, Sample* s1, Sample* s2,
+                              Sample b0, Sample b1, Sample b2, Sample a1, Sample a2)
+        {
+            Sample x[NumLanes], y[NumLanes];
+            for (int lane = 0; lane < NumLanes; ++lane)
+                x[lane] = frame[lane];
+            for (int lane = 0; lane < NumLanes; ++lane)
+                y[lane] = b0 * x[lane] + s1[lane];
+            for (int lane = 0; lane < NumLanes; ++lane)
+                s1[lane] = b1 * x[lane] - a1 * y[lane] + s2[lane];
+            for (int lane = 0; lane < NumLanes; ++lane)
+                s2[lane] = b2 * x[lane] - a2 * y[lane];
+            for (int lane = 0; lane < NumLanes; ++lane)
+                frame[lane] = y[lane];
+        }
+
+        // look-ahead forms, kept in step with sections by setCoefficients() and
+        // marked stale by ramps until the next look-ahead call
+        struct NoBlockForms {};
+        using BlockForms = std::conditional_t<NumLanes == 1, std::array<BiquadBlockForm, NumSections>, NoBlockForms>;
+        using StaleFlags = std::conditional_t<NumLanes == 1, std::array<bool, NumSections>, NoBlockForms>;
+        BlockForms blockForms = makeIdentityForms();
+        StaleFlags blockFormStale {};
+
+        static BlockForms makeIdentityForms()
+        {
+            BlockForms forms {};
+            if constexpr (NumLanes == 1)
+                forms.fill(BiquadBlockForm::make(BiquadCoefficients<Sample> {}));
+            return forms;
+        }
+};
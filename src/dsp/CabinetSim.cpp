@@ -0,0 +1,369 @@
+# include "CabinetSim.h"
+
+# include <algorithm>
+# include <cmath>
+
+namespace
+{
+    constexpr double pi = 3.14159265358979323846;
+
+    // windowed-sinc resampling, ratio = output rate / input rate; stops after maxLength outputs
+    std::vector<double> resample(const std::vector<float>& input, double ratio, int maxLength)
+    {
+        const int inputLength = static_cast<int>(input.size());
+        const int outputLength = std::min(maxLength, static_cast<int>(std::ceil(inputLength * ratio)));
+        std::vector<double> output(static_cast<std::size_t>(std::max(0, outputLength)), 0.0);
+
+        if (ratio == 1.0)
+        {
+            std::copy(input.begin(), input.begin() + outputLength, output.begin());
+            return output;
+        }
+
+        // band limit to the lower of the two Nyquist rates, Blackman window
+        // over 16 zero crossings of the kernel on either side
+        const double cutoff = std::min(1.0, ratio);
+        const double halfWidth = 16.0 / cutoff;
+
+        for (int m = 0; m < outputLength; ++m)
+        {
+            const double t = m / ratio;
+            const int first = std::max(0, static_cast<int>(std::ceil(t - halfWidth)));
+            const int last = std::min(inputLength - 1, static_cast<int>(std::floor(t + halfWidth)));
+
+            double sum = 0.0;
+            for (int k = first; k <= last; ++k)
+            {
+                const double u = t - k;
+                const double x = pi * cutoff * u;
+                const double sinc = std::abs(x) < 1.0e-9 ? 1.0 : std::sin(x) / x;
+                const double window = 0.42 + 0.5 * std::cos(pi * u / halfWidth) + 0.08 * std::cos(2.0 * pi * u / halfWidth);
+                sum += input[static_cast<std::size_t>(k)] * cutoff * sinc * window;
+            }
+            output[static_cast<std::size_t>(m)] = sum;
+        }
+
+        return output;
+    }
+
+    // spectra of consecutive partition-sized segments of h starting at offset,
+    // each zero-padded to twice its size for overlap-save
+    template <typename Sample>
+    void partitionSpectra(const std::vector<double>& h, int offset, int partition, int numPartitions,
+                          std::vector<Sample>& real, std::vector<Sample>& imag)
+    {
+        const int bins = partition + 1;
+        real.assign(static_cast<std::size_t>(numPartitions * bins), Sample(0));
+        imag.assign(real.size(), Sample(0));
+
+        RealFFT<Sample> fft;
+        fft.prepare(static_cast<int>(std::log2(2 * partition)));
+        std::vector<Sample> segment(static_cast<std::size_t>(2 * partition));
+
+        for (int p = 0; p < numPartitions; ++p)
+        {
+            std::fill(segment.begin(), segment.end(), Sample(0));
+            const int start = offset + p * partition;
+            const int end = std::min(static_cast<int>(h.size()), start + partition);
+            for (int i = start; i < end; ++i)
+                segment[static_cast<std::size_t>(i - start)] = static_cast<Sample>(h[static_cast<std::size_t>(i)]);
+
+            fft.forward(segment.data(), real.data() + p * bins, imag.data() + p * bins);
+        }
+    }
+
+    // acc += x * h over bins, split complex
+    template <typename Sample>
+    void multiplyAccumulate(Sample* accReal, Sample* accImag, const Sample* xReal, const Sample* xImag,
+                            const Sample* hReal, const Sample* hImag, int bins)
+    {
+        for (int b = 0; b < bins; ++b)
+        {
+            accReal[b] += xReal[b] * hReal[b] - xImag[b] * hImag[b];
+            accImag[b] += xReal[b] * hImag[b] + xImag[b] * hReal[b];
+        }
+    }
+
+    template <typename Sample>
+    void resizeTier(std::vector<Sample>& buffer, int size)
+    {
+        buffer.assign(static_cast<std::size_t>(size), Sample(0));
+    }
+}
+
+// constructor
+template <typename Sample>
+CabinetSim<Sample>::CabinetSim()
+{
+    shortFFT.prepare(static_cast<int>(std::log2(2 * headLength)));
+    longFFT.prepare(static_cast<int>(std::log2(2 * longPartition)));
+    accumulateReal.assign(longBins, Sample(0));
+    accumulateImag.assign(longBins, Sample(0));
+    transformScratch.assign(2 * longPartition, Sample(0));
+}
+
+template <typename Sample>
+CabinetSim<Sample>::~CabinetSim()
+{
+    delete active;
+    delete pending.load();
+    delete retired.load();
+}
+
+// allocate per-channel state for the rate and rebuild the impulse for it.
+// the audio thread is stopped here, so the handover slots can be reset directly
+template <typename Sample>
+void CabinetSim<Sample>::prepare(float sampleRate, int numChannels)
+{
+    std::lock_guard<std::mutex> lock(loaderMutex);
+
+    preparedRate = sampleRate;
+    const int maxTaps = static_cast<int>(std::ceil(maxImpulseSeconds * sampleRate));
+    maxLongPartitions = std::max(1, (maxTaps - 1) / longPartition);
+
+    channelStates.resize(static_cast<std::size_t>(std::max(1, numChannels)));
+    for (Channel& channel : channelStates)
+    {
+        resizeTier(channel.shortTier.input, 2 * headLength);
+        resizeTier(channel.shortTier.spectraReal, maxShortPartitions * shortBins);
+        resizeTier(channel.shortTier.spectraImag, maxShortPartitions * shortBins);
+        resizeTier(channel.shortTier.output, headLength);
+        resizeTier(channel.longTier.input, 2 * longPartition);
+        resizeTier(channel.longTier.spectraReal, maxLongPartitions * longBins);
+        resizeTier(channel.longTier.spectraImag, maxLongPartitions * longBins);
+        resizeTier(channel.longTier.output, longPartition);
+    }
+
+    delete pending.exchange(nullptr);
+    delete retired.exchange(nullptr);
+    delete active;
+    active = source.empty() ? nullptr : buildImpulse();
+
+    reset();
+}
+
+template <typename Sample>
+void CabinetSim<Sample>::reset()
+{
+    clearChannels();
+    running = false;
+}
+
+template <typename Sample>
+void CabinetSim<Sample>::clearChannels()
+{
+    for (Channel& channel : channelStates)
+    {
+        for (Tier* tier : { &channel.shortTier, &channel.longTier })
+        {
+            std::fill(tier->input.begin(), tier->input.end(), Sample(0));
+            std::fill(tier->output.begin(), tier->output.end(), Sample(0));
+            tier->newest = 0;
+            tier->filled = 0;
+        }
+
+        channel.shortPosition = 0;
+        channel.longPosition = 0;
+    }
+}
+
+template <typename Sample>
+bool CabinetSim<Sample>::loadImpulse(const float* samples, int numSamples, float impulseSampleRate)
+{
+    if (samples == nullptr || numSamples <= 0 || !(impulseSampleRate > 0.0f))
+        return false;
+
+    if (std::none_of(samples, samples + numSamples, [](float value) { return value != 0.0f; }))
+        return false;
+
+    std::lock_guard<std::mutex> lock(loaderMutex);
+
+    const int maxSourceSamples = static_cast<int>(std::ceil(maxImpulseSeconds * impulseSampleRate));
+    source.assign(samples, samples + std::min(numSamples, maxSourceSamples));
+    sourceRate = impulseSampleRate;
+    impulseSeconds.store(static_cast<float>(source.size()) / sourceRate, std::memory_order_relaxed);
+
+    // before the first prepare() the impulse is only stored, prepare() builds it
+    if (preparedRate > 0.0f)
+        publish(buildImpulse());
+
+    return true;
+}
+
+template <typename Sample>
+typename CabinetSim<Sample>::Impulse* CabinetSim<Sample>::buildImpulse() const
+{
+    const int maxTaps = std::min(static_cast<int>(std::ceil(maxImpulseSeconds * preparedRate)),
+                                 longPartition + maxLongPartitions * longPartition);
+    std::vector<double> h = resample(source, static_cast<double>(preparedRate) / sourceRate, maxTaps);
+
+    double energy = 0.0;
+    for (double value : h)
+        energy += value * value;
+    const double scale = energy > 0.0 ? 1.0 / std::sqrt(energy) : 0.0;
+    for (double& value : h)
+        value *= scale;
+
+    const int length = static_cast<int>(h.size());
+    auto* impulse = new Impulse();
+
+    impulse->head.assign(headLength, Sample(0));
+    for (int i = 0; i < std::min(length, headLength); ++i)
+        impulse->head[static_cast<std::size_t>(headLength - 1 - i)] = static_cast<Sample>(h[static_cast<std::size_t>(i)]);
+
+    const int shortTaps = std::min(length, longPartition) - headLength;
+    impulse->numShort = std::clamp((shortTaps + headLength - 1) / headLength, 0, maxShortPartitions);
+    partitionSpectra(h, headLength, headLength, impulse->numShort, impulse->shortReal, impulse->shortImag);
+
+    const int longTaps = length - longPartition;
+    impulse->numLong = std::clamp((longTaps + longPartition - 1) / longPartition, 0, maxLongPartitions);
+    partitionSpectra(h, longPartition, longPartition, impulse->numLong, impulse->longReal, impulse->longImag);
+
+    return impulse;
+}
+
+// replace pending first: anything the audio thread adopted before that point
+// has already moved its predecessor to retired, which is freed next
+template <typename Sample>
+void CabinetSim<Sample>::publish(Impulse* next)
+{
+    delete pending.exchange(next, std::memory_order_acq_rel);
+    delete retired.exchange(nullptr, std::memory_order_acquire);
+}
+
+template <typename Sample>
+void CabinetSim<Sample>::adoptPendingImpulse()
+{
+    if (pending.load(std::memory_order_relaxed) == nullptr || retired.load(std::memory_order_acquire) != nullptr)
+        return;
+
+    Impulse* next = pending.exchange(nullptr, std::memory_order_acquire);
+    if (next == nullptr)
+        return;
+
+    retired.store(active, std::memory_order_release);
+    active = next;
+}
+
+template <typename Sample>
+void CabinetSim<Sample>::processBlock(Sample* const* channels, int numChannels, int numSamples)
+{
+    ScopedFlushDenormals flushDenormals;
+    ODPEDAL_TRACE_SCOPE("CabinetSim::processBlock");
+    ODPEDAL_REALTIME_SCOPE("CabinetSim::processBlock");
+
+    adoptPendingImpulse();
+
+    if (!enabled || active == nullptr)
+    {
+        running = false;
+        return;
+    }
+
+    // history from before a pass-through stretch would replay stale audio
+    if (!running)
+    {
+        clearChannels();
+        running = true;
+    }
+
+    const int count = std::min(numChannels, static_cast<int>(channelStates.size()));
+    for (int c = 0; c < count; ++c)
+        processChannel(channelStates[static_cast<std::size_t>(c)], channels[c], numSamples);
+}
+
+template <typename Sample>
+void CabinetSim<Sample>::processChannel(Channel& channel, Sample* samples, int numSamples)
+{
+    const Impulse& impulse = *active;
+    Tier& shortTier = channel.shortTier;
+    Tier& longTier = channel.longTier;
+    alignas(64) Sample head[headLength];
+
+    for (int i = 0; i < numSamples;)
+    {
+        // runs end at short block boundaries, which long block boundaries are a subset of
+        const int run = std::min(numSamples - i, headLength - channel.shortPosition);
+        Sample* block = samples + i;
+
+        std::copy(block, block + run, shortTier.input.data() + headLength + channel.shortPosition);
+        std::copy(block, block + run, longTier.input.data() + longPartition + channel.longPosition);
+
+        // direct form over the last headLength inputs, vectorized across the run's outputs
+        const Sample* window = shortTier.input.data() + channel.shortPosition + 1;
+        std::fill(head, head + run, Sample(0));
+        for (int t = 0; t < headLength; ++t)
+        {
+            const Sample tap = impulse.head[static_cast<std::size_t>(t)];
+            for (int k = 0; k < run; ++k)
+                head[k] += tap * window[k + t];
+        }
+
+        const Sample* shortOutput = shortTier.output.data() + channel.shortPosition;
+        const Sample* longOutput = longTier.output.data() + channel.longPosition;
+        for (int k = 0; k < run; ++k)
+            block[k] = head[k] + shortOutput[k] + longOutput[k];
+
+        i += run;
+        channel.shortPosition += run;
+        channel.longPosition += run;
+
+        if (channel.shortPosition == headLength)
+        {
+            runTier(shortTier, shortFFT, headLength, maxShortPartitions,
+                    impulse.shortReal.data(), impulse.shortImag.data(), impulse.numShort);
+            channel.shortPosition = 0;
+        }
+
+        if (channel.longPosition == longPartition)
+        {
+            runTier(longTier, longFFT, longPartition, maxLongPartitions,
+                    impulse.longReal.data(), impulse.longImag.data(), impulse.numLong);
+            channel.longPosition = 0;
+        }
+    }
+}
+
+template <typename Sample>
+void CabinetSim<Sample>::runTier(Tier& tier, RealFFT<Sample>& fft, int partition, int ringSize,
+                                 const Sample* filterReal, const Sample* filterImag, int numPartitions)
+{
+    const int bins = partition + 1;
+
+    // the ring runs backwards, so partition p pairs with slot newest + p
+    tier.newest = tier.newest == 0 ? ringSize - 1 : tier.newest - 1;
+    fft.forward(tier.input.data(), tier.spectraReal.data() + tier.newest * bins, tier.spectraImag.data() + tier.newest * bins);
+    std::copy(tier.input.begin() + partition, tier.input.end(), tier.input.begin());
+    tier.filled = std::min(tier.filled + 1, ringSize);
+
+    // slots from before the last clear hold stale audio, they stand for silence
+    numPartitions = std::min(numPartitions, tier.filled);
+    if (numPartitions == 0)
+    {
+        std::fill(tier.output.begin(), tier.output.end(), Sample(0));
+        return;
+    }
+
+    Sample* accReal = accumulateReal.data();
+    Sample* accImag = accumulateImag.data();
+    std::fill(accReal, accReal + bins, Sample(0));
+    std::fill(accImag, accImag + bins, Sample(0));
+
+    for (int p = 0; p < numPartitions; ++p)
+    {
+        int slot = tier.newest + p;
+        if (slot >= ringSize)
+            slot -= ringSize;
+
+        multiplyAccumulate(accReal, accImag,
+                           tier.spectraReal.data() + slot * bins, tier.spectraImag.data() + slot * bins,
+                           filterReal + p * bins, filterImag + p * bins, bins);
+    }
+
+    // overlap-save: the second half holds the linear convolution of this block
+    fft.inverse(accReal, accImag, transformScratch.data());
+    std::copy(transformScratch.begin() + partition, transformScratch.begin() + 2 * partition, tier.output.begin());
+}
+
+template class CabinetSim<float>;
+template class CabinetSim<double>;
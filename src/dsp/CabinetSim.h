@@ -0,0 +1,141 @@
+# pragma once
+
+# include <atomic>
+# include <mutex>
+# include <vector>
+
+# include "DenormalGuard.h"
+# include "RealFFT.h"
+# include "RealtimeCheck.h"
+# include "TraceRecorder.h"
+
+// speaker cabinet stage: convolution with a loaded impulse response, without
+// latency. the impulse is split three ways:
+//   h[0, headLength)                 direct-form FIR, so the output has no delay
+//   h[headLength, longPartition)     uniformly partitioned overlap-save FFT blocks
+//                                    of headLength, computed at the end of each block
+//                                    and played during the next one
+//   h[longPartition, end)            the same with longPartition sized blocks, so
+//                                    long impulses cost few large FFTs instead of
+//                                    many small ones
+// past input spectra are kept per partition size and do not depend on the
+// impulse, so a newly loaded impulse takes over mid-stream without clearing.
+//
+// loadImpulse() resamples and partitions on the calling (non-audio) thread and
+// hands the result to the audio thread through an atomic pointer; the audio
+// thread never allocates, locks or frees. prepare() allocates every buffer.
+template <typename Sample>
+class CabinetSim
+{
+    public:
+        using SampleType = Sample;
+
+        // direct-form taps, also the short partition size
+        static constexpr int headLength = 64;
+        // partition size past the first longPartition taps
+        static constexpr int longPartition = 1024;
+        // longer impulses are truncated
+        static constexpr float maxImpulseSeconds = 1.0f;
+
+        CabinetSim();
+        ~CabinetSim();
+
+        CabinetSim(const CabinetSim&) = delete;
+        CabinetSim& operator=(const CabinetSim&) = delete;
+
+        // PedalStage interface (PedalChain.h). prepare() also rebuilds the
+        // loaded impulse for the new sample rate
+        void prepare(float sampleRate, int numChannels);
+        void reset();
+        void processBlock(Sample* const* channels, int numChannels, int numSamples);
+
+        // switch the stage in or out from the next processBlock() on. the stage
+        // also passes audio through unchanged while no impulse is loaded
+        void setEnabled(bool shouldBeEnabled) { enabled = shouldBeEnabled; }
+
+        // load a mono impulse response recorded at impulseSampleRate, from any
+        // thread except the audio thread. it is resampled to the prepared rate,
+        // truncated to maxImpulseSeconds and scaled to unit energy, so swapping
+        // impulses keeps the level roughly constant. false for an empty or
+        // silent impulse, which leaves the current one in place
+        bool loadImpulse(const float* samples, int numSamples, float impulseSampleRate);
+
+        // length of the loaded impulse in seconds, 0 without one (tail length)
+        float getImpulseSeconds() const { return impulseSeconds.load(std::memory_order_relaxed); }
+
+    private:
+        // one impulse partitioned for the prepared rate, read-only once published
+        struct Impulse
+        {
+            std::vector<Sample> head;                   // first headLength taps, time-reversed
+            int numShort = 0;
+            int numLong = 0;
+            std::vector<Sample> shortReal, shortImag;   // numShort spectra of shortBins
+            std::vector<Sample> longReal, longImag;     // numLong spectra of longBins
+        };
+
+        // overlap-save state of one partition size for one channel
+        struct Tier
+        {
+            std::vector<Sample> input;                  // previous and current block
+            std::vector<Sample> spectraReal, spectraImag;   // ring of past input block spectra
+            std::vector<Sample> output;                 // this tier's share of the block being played
+            int newest = 0;                             // ring slot of the latest spectrum
+            int filled = 0;                             // slots written since the last clear, the rest read as silence
+        };
+
+        struct Channel
+        {
+            Tier shortTier;
+            Tier longTier;
+            int shortPosition = 0;                      // samples into the current short block
+            int longPosition = 0;                       // samples into the current long block
+        };
+
+        static constexpr int shortBins = headLength + 1;
+        static constexpr int longBins = longPartition + 1;
+        static constexpr int maxShortPartitions = longPartition / headLength - 1;
+
+        // audio thread state
+        bool enabled = true;
+        bool running = false;                           // processed the previous block
+        std::vector<Channel> channelStates;
+        Impulse* active = nullptr;
+        RealFFT<Sample> shortFFT, longFFT;
+        std::vector<Sample> accumulateReal, accumulateImag, transformScratch;
+
+        // handover between loader and audio thread: the loader replaces
+        // pending, the audio thread swaps it in and parks the old impulse in
+        // retired, which the loader frees on its next load
+        std::atomic<Impulse*> pending { nullptr };
+        std::atomic<Impulse*> retired { nullptr };
+        std::atomic<float> impulseSeconds { 0.0f };
+
+        // loader state, guarded by loaderMutex
+        std::mutex loaderMutex;
+        std::vector<float> source;                      // impulse as loaded
+        float sourceRate = 0.0f;
+        float preparedRate = 0.0f;                      // 0 until the first prepare()
+        int maxLongPartitions = 1;
+
+        // resample and partition the source for the prepared rate
+        Impulse* buildImpulse() const;
+
+        // hand a new impulse to the audio thread and free what it let go of
+        void publish(Impulse* next);
+
+        // audio thread: take over a published impulse when the last one has been freed
+        void adoptPendingImpulse();
+
+        // zero every channel's history. the spectra rings are left as they are and
+        // marked empty instead, so clearing costs the same for any impulse length
+        void clearChannels();
+
+        // convolve one channel in place
+        void processChannel(Channel& channel, Sample* samples, int numSamples);
+
+        // at the end of a block: transform it into the ring, then accumulate
+        // its partitions and write the tier's output for the next block
+        void runTier(Tier& tier, RealFFT<Sample>& fft, int partition, int ringSize,
+                     const Sample* filterReal, const Sample* filterImag, int numPartitions);
+};
@@ -0,0 +1,50 @@
+# pragma once
+
+# include <cstdint>
+
+# if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    # include <xmmintrin.h>
+    # define ODPEDAL_HAS_MXCSR 1
+# endif
+
+// flushes denormals to zero for the lifetime of the object and restores the
+// previous floating point mode afterwards. decaying filter states would
+// otherwise fall into the denormal range, where every operation is many times
+// slower. on x86 this sets FTZ and DAZ in MXCSR, on AArch64 the FZ bit in FPCR,
+// elsewhere it does nothing.
+class ScopedFlushDenormals
+{
+    public:
+        ScopedFlushDenormals()
+        {
+        # if defined(ODPEDAL_HAS_MXCSR)
+            previousMode = _mm_getcsr();
+            _mm_setcsr(previousMode | flushToZeroBit | denormalsAreZeroBit);
+        # elif defined(__aarch64__)
+            asm volatile("mrs %0, fpcr" : "=r"(previousMode));
+            asm volatile("msr fpcr, %0" : : "r"(previousMode | flushToZeroBit));
+        # endif
+        }
+
+        ~ScopedFlushDenormals()
+        {
+        # if defined(ODPEDAL_HAS_MXCSR)
+            _mm_setcsr(previousMode);
+        # elif defined(__aarch64__)
+            asm volatile("msr fpcr, %0" : : "r"(previousMode));
+        # endif
+        }
+
+        ScopedFlushDenormals(const ScopedFlushDenormals&) = delete;
+        ScopedFlushDenormals& operator=(const ScopedFlushDenormals&) = delete;
+
+    private:
+    # if defined(ODPEDAL_HAS_MXCSR)
+        static constexpr unsigned int flushToZeroBit = 0x8000;
+        static constexpr unsigned int denormalsAreZeroBit = 0x0040;
+        unsigned int previousMode = 0;
+    # elif defined(__aarch64__)
+        static constexpr std::uint64_t flushToZeroBit = std::uint64_t(1) << 24;
+        std::uint64_t previousMode = 0;
+    # endif
+};
@@ -0,0 +1,294 @@
+# pragma once
+
+# include <cmath>
+# include <algorithm>
+# include <array>
+
+# include "Biquad.h"
+# include "DenormalGuard.h"
+# include "Saturators.h"
+
+// runs NumVoices independent overdrive channels in lock-step.
+// every biquad history and coefficient is stored structure-of-arrays (one array
+// per variable, one lane per voice) so each step of the chain is a fixed-width
+// loop over the lanes that the compiler maps onto SSE (4) / AVX2 (8) registers.
+// every kernel in the chain is plain arithmetic so those loops vectorize; the
+// Exact clipper runs Saturators::tanhAccurate instead of the std::tanh call,
+// which would leave the clipper scalar. od_golden matches every voice against
+// OverdriveDSP and od_bench times the bank per voice.
+template <int NumVoices>
+class OverdriveBank
+{
+    public:
+        static_assert(NumVoices == 4 || NumVoices == 8 || NumVoices == 16,
+                      "OverdriveBank supports 4, 8 or 16 voices");
+
+        // constructor
+        OverdriveBank();
+
+        // prepare the bank with the given sample rate and clipper kernel
+        void prepare(float sampleRate, SaturatorType saturatorType = SaturatorType::Exact);
+
+        // audio processing loop, one buffer and one drive/tone/level value per voice.
+        // a null buffer marks an unused voice, it is processed as silence.
+        void process(float* const* buffers, int numSamples,
+                     const float* drive, const float* tone, const float* level);
+
+        // reset the state of every voice
+        void reset();
+
+    private:
+        // voices are interleaved into a lane-major scratch block of this many frames
+        static constexpr int framesPerBlock = 64;
+
+        // one float per voice, aligned for full-width vector loads
+        struct alignas(64) Lanes
+        {
+            float v[NumVoices];
+        };
+
+        // transposed direct form II biquad, SoA across voices
+        struct BiquadLanes
+        {
+            Lanes b0, b1, b2, a1, a2;
+            Lanes s1, s2;
+        };
+
+        // DSP state variables
+        float sampleRate = 44100.0f;
+        float fixedGain = 2.0f;
+        float driveExponent = 1.5f;
+
+        // filters
+        static constexpr float filterQ = 0.707f;
+        static constexpr float hpfCutoff = 720.0f;       // Hz
+        static constexpr float postLPFCutoff = 7000.0f;  // Hz, fixed
+
+        // clipper kernel selected in prepare()
+        SaturatorType saturator = SaturatorType::Exact;
+        const float* lookupTable = nullptr;
+
+        BiquadLanes hpf;
+        BiquadLanes postLPF;
+        BiquadLanes lpf;
+
+        Lanes previousTone;
+        Lanes driveLinear;
+        Lanes levelLinear;
+
+        alignas(64) float scratch[framesPerBlock * NumVoices];
+
+        // helper to load one voice's coefficients into a filter
+        static void setCoefficients(BiquadLanes& filter, int voice, const BiquadCoefficients<float>& coefficients);
+
+        // helper to clear the history of one filter
+        static void clearHistory(BiquadLanes& filter);
+
+        // run one biquad over numFrames frames of NumVoices samples
+        static void applyBiquad(BiquadLanes& filter, float* frames, int numFrames);
+
+        // run the whole chain over the interleaved scratch block
+        template <SaturatorType Type>
+        void processFrames(int numFrames);
+};
+
+// constructor
+template <int NumVoices>
+OverdriveBank<NumVoices>::OverdriveBank()
+{
+    std::fill(std::begin(scratch), std::end(scratch), 0.0f);
+    reset();
+}
+
+// prepare the bank with the given sample rate and clipper kernel
+template <int NumVoices>
+void OverdriveBank<NumVoices>::prepare(float newSampleRate, SaturatorType saturatorType)
+{
+    sampleRate = newSampleRate;
+    saturator = saturatorType;
+
+    if (saturator == SaturatorType::Lookup)
+    {
+        Saturators::prepareLookupTable();
+        lookupTable = Saturators::getLookupTable();
+    }
+
+    reset();
+
+    BiquadCoefficients<float> hpfCoefficients = BiquadCoefficients<float>::makeHighPass(sampleRate, hpfCutoff, filterQ);
+    BiquadCoefficients<float> postLPFCoefficients = BiquadCoefficients<float>::makeLowPass(sampleRate, postLPFCutoff, filterQ);
+    BiquadCoefficients<float> lpfCoefficients = BiquadCoefficients<float>::makeLowPass(sampleRate, 800.0f, filterQ);
+
+    for (int v = 0; v < NumVoices; ++v)
+    {
+        setCoefficients(hpf, v, hpfCoefficients);
+        setCoefficients(postLPF, v, postLPFCoefficients);
+        setCoefficients(lpf, v, lpfCoefficients);
+    }
+}
+
+// reset the state of every voice
+template <int NumVoices>
+void OverdriveBank<NumVoices>::reset()
+{
+    clearHistory(hpf);
+    clearHistory(postLPF);
+    clearHistory(lpf);
+
+    for (int v = 0; v < NumVoices; ++v)
+        previousTone.v[v] = 0.0f;
+}
+
+template <int NumVoices>
+void OverdriveBank<NumVoices>::clearHistory(BiquadLanes& filter)
+{
+    for (int v = 0; v < NumVoices; ++v)
+    {
+        filter.s1.v[v] = 0.0f;
+        filter.s2.v[v] = 0.0f;
+    }
+}
+
+// helper to load one voice's coefficients into a filter
+template <int NumVoices>
+void OverdriveBank<NumVoices>::setCoefficients(BiquadLanes& filter, int voice, const BiquadCoefficients<float>& c)
+{
+    filter.b0.v[voice] = c.b0;
+    filter.b1.v[voice] = c.b1;
+    filter.b2.v[voice] = c.b2;
+    filter.a1.v[voice] = c.a1;
+    filter.a2.v[voice] = c.a2;
+}
+
+// one biquad across every frame of the scratch block. the state lives in
+// locals for the block and each statement is its own loop over the lanes, so
+// every step maps onto full-width vector operations
+template <int NumVoices>
+void OverdriveBank<NumVoices>::applyBiquad(BiquadLanes& f, float* frames, int numFrames)
+{
+    alignas(64) float s1[NumVoices];
+    alignas(64) float s2[NumVoices];
+    for (int v = 0; v < NumVoices; ++v)
+    {
+        s1[v] = f.s1.v[v];
+        s2[v] = f.s2.v[v];
+    }
+
+    for (int i = 0; i < numFrames; ++i)
+    {
+        float* frame = frames + i * NumVoices;
+        alignas(64) float x[NumVoices];
+        alignas(64) float y[NumVoices];
+
+        for (int v = 0; v < NumVoices; ++v)
+            x[v] = frame[v];
+        for (int v = 0; v < NumVoices; ++v)
+            y[v] = f.b0.v[v] * x[v] + s1[v];
+        for (int v = 0; v < NumVoices; ++v)
+            s1[v] = f.b1.v[v] * x[v] - f.a1.v[v] * y[v] + s2[v];
+        for (int v = 0; v < NumVoices; ++v)
+            s2[v] = f.b2.v[v] * x[v] - f.a2.v[v] * y[v];
+        for (int v = 0; v < NumVoices; ++v)
+            frame[v] = y[v];
+    }
+
+    for (int v = 0; v < NumVoices; ++v)
+    {
+        f.s1.v[v] = s1[v];
+        f.s2.v[v] = s2[v];
+    }
+}
+
+// HPF -> tanh clip -> post LPF -> tone LPF, each stage as its own pass over
+// the scratch block like OverdriveDSP's lane groups
+template <int NumVoices>
+template <SaturatorType Type>
+void OverdriveBank<NumVoices>::processFrames(int numFrames)
+{
+    // apply fixed gain and drive
+    for (int i = 0; i < numFrames; ++i)
+        for (int v = 0; v < NumVoices; ++v)
+            scratch[i * NumVoices + v] *= fixedGain * driveLinear.v[v];
+
+    applyBiquad(hpf, scratch, numFrames);
+
+    // soft clipping, element-wise over the whole block
+    const int numValues = numFrames * NumVoices;
+    for (int n = 0; n < numValues; ++n)
+    {
+        if constexpr (Type == SaturatorType::Pade)
+            scratch[n] = Saturators::tanhPade(scratch[n]);
+        else if constexpr (Type == SaturatorType::Polynomial)
+            scratch[n] = Saturators::tanhPolynomial(scratch[n]);
+        else if constexpr (Type == SaturatorType::Lookup)
+            scratch[n] = Saturators::tanhLookup(lookupTable, scratch[n]);
+        else
+            scratch[n] = Saturators::tanhAccurate(scratch[n]);
+    }
+
+    applyBiquad(postLPF, scratch, numFrames);
+    applyBiquad(lpf, scratch, numFrames);
+
+    // apply output level
+    for (int i = 0; i < numFrames; ++i)
+        for (int v = 0; v < NumVoices; ++v)
+            scratch[i * NumVoices + v] *= levelLinear.v[v];
+}
+
+// audio processing loop
+template <int NumVoices>
+void OverdriveBank<NumVoices>::process(float* const* buffers, int numSamples,
+                                       const float* drive, const float* tone, const float* level)
+{
+    // idle voices decay towards denormals, keep them flushed to zero
+    ScopedFlushDenormals flushDenormals;
+
+    // per-voice parameters are block-rate, so coefficients only change here
+    for (int v = 0; v < NumVoices; ++v)
+    {
+        driveLinear.v[v] = std::pow(10.0f, (drive[v] / 20.0f) * driveExponent);
+        levelLinear.v[v] = std::pow(10.0f, level[v] / 20.0f);
+
+        if (tone[v] != previousTone.v[v])
+        {
+            setCoefficients(lpf, v, BiquadCoefficients<float>::makeLowPass(sampleRate, tone[v], filterQ));
+            previousTone.v[v] = tone[v];
+        }
+    }
+
+    for (int start = 0; start < numSamples; start += framesPerBlock)
+    {
+        int numFrames = std::min(framesPerBlock, numSamples - start);
+
+        // interleave voices into lanes
+        for (int v = 0; v < NumVoices; ++v)
+        {
+            const float* source = buffers[v];
+            for (int i = 0; i < numFrames; ++i)
+                scratch[i * NumVoices + v] = source != nullptr ? source[start + i] : 0.0f;
+        }
+
+        switch (saturator)
+        {
+            case SaturatorType::Exact:      processFrames<SaturatorType::Exact>(numFrames); break;
+            case SaturatorType::Pade:       processFrames<SaturatorType::Pade>(numFrames); break;
+            case SaturatorType::Polynomial: processFrames<SaturatorType::Polynomial>(numFrames); break;
+            case SaturatorType::Lookup:     processFrames<SaturatorType::Lookup>(numFrames); break;
+
+            // the bank keeps no clipper history, ADAA requests run the plain tanh
+            case SaturatorType::Adaa1:
+            case SaturatorType::Adaa2:      processFrames<SaturatorType::Exact>(numFrames); break;
+        }
+
+        // de-interleave back into the voice buffers
+        for (int v = 0; v < NumVoices; ++v)
+        {
+            float* destination = buffers[v];
+            if (destination == nullptr)
+                continue;
+
+            for (int i = 0; i < numFrames; ++i)
+                destination[start + i] = scratch[i * NumVoices + v];
+        }
+    }
+}
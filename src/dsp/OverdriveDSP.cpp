@@ -1,215 +1,691 @@
 # include "OverdriveDSP.h"
 
+namespace
+{
+    // largest magnitude in a buffer, element-wise partial maxima so the loop vectorizes
+    template <typename Sample>
+    float peakMagnitude(const Sample* samples, int numSamples)
+    {
+        constexpr int width = 8;
+        Sample partial[width] = {};
+        int i = 0;
+
+        for (; i + width <= numSamples; i += width)
+        {
+            for (int j = 0; j < width; ++j)
+                partial[j] = std::max(partial[j], std::abs(samples[i + j]));
+        }
+
+        Sample peak = 0;
+        for (; i < numSamples; ++i)
+            peak = std::max(peak, std::abs(samples[i]));
+        for (Sample value : partial)
+            peak = std::max(peak, value);
+
+        return static_cast<float>(peak);
+    }
+}
+
 // constructor
-OverdriveDSP::OverdriveDSP()
+template <typename Sample>
+OverdriveDSP<Sample>::OverdriveDSP()
 {
     sampleRate = 44100.0f;
-    previousTone = 0.0f;
-    lp_inputHistory1 = 0.0f;
-    lp_inputHistory2 = 0.0f;
-    lp_outputHistory1 = 0.0f;
-    lp_outputHistory2 = 0.0f;
+    std::fill(std::begin(scratch), std::end(scratch), Sample(0));
+    std::fill(std::begin(fadeScratch), std::end(fadeScratch), Sample(0));
 }
 
-// prepare the DSP with the given sample rate
-void OverdriveDSP::prepare(float newSampleRate)
+// prepare the DSP with the given sample rate, channel count and clipper kernel
+template <typename Sample>
+void OverdriveDSP<Sample>::prepare(float newSampleRate, int numChannels, SaturatorType saturatorType)
 {
     sampleRate = newSampleRate;
+    saturator = saturatorType;
+    preparedChannels = std::max(1, numChannels);
+
+    if (saturator == SaturatorType::Lookup)
+        Saturators::prepareLookupTable();
+
+    driveSmoother.prepare(sampleRate, smoothingSeconds, smoothingType);
+    levelSmoother.prepare(sampleRate, smoothingSeconds, smoothingType);
+    toneSmoother.prepare(sampleRate, smoothingSeconds, smoothingType);
+
+    // mono runs in place, stereo in the pair group, anything wider is split into lane groups
+    laneGroups.resize(preparedChannels > pairWidth ? (preparedChannels + laneWidth - 1) / laneWidth : 0);
+    fadeLaneGroups.resize(laneGroups.size());
+    programFadeSamples = std::max(1, static_cast<int>(std::lround(sampleRate * programFadeSeconds)));
+    envelopeAttack = 1.0f - std::exp(-static_cast<float>(chunkFrames) / (envelopeAttackSeconds * sampleRate));
+    envelopeRelease = 1.0f - std::exp(-static_cast<float>(chunkFrames) / (envelopeReleaseSeconds * sampleRate));
+
+    prepareGroup(monoGroup);
+    prepareGroup(pairGroup);
+    for (auto& group : laneGroups)
+        prepareGroup(group);
+
+    setToneCoefficients(800.0f);
     reset();
-    updateHPFCoefficients();
-    updatePostLPFCoefficients();
-    updateLPFCoefficients(800.0f);
+}
+
+// helper to jump every channel group to a tone cutoff without a ramp
+template <typename Sample>
+void OverdriveDSP<Sample>::setToneCoefficients(float tone)
+{
+    toneCoefficients = BiquadCoefficients<Sample>::makeLowPass(sampleRate, tone, filterQ);
+    coefficientTone = tone;
+
+    monoGroup.lpf.setCoefficients(toneSection, toneCoefficients);
+    pairGroup.lpf.setCoefficients(toneSection, toneCoefficients);
+    for (auto& group : laneGroups)
+        group.lpf.setCoefficients(toneSection, toneCoefficients);
+}
+
+template <typename Sample>
+template <int Lanes>
+void OverdriveDSP<Sample>::prepareGroup(ChannelGroup<Lanes>& group)
+{
+    group.hpf.setCoefficients(0, BiquadCoefficients<Sample>::makeHighPass(sampleRate, hpfCutoff, filterQ));
+    group.lpf.setCoefficients(postLPFSection, BiquadCoefficients<Sample>::makeLowPass(sampleRate, postLPFCutoff, filterQ));
+}
+
+// parameter ramp shape and length, applied on the next prepare()
+template <typename Sample>
+void OverdriveDSP<Sample>::setSmoothing(float rampSeconds, SmoothingType type)
+{
+    smoothingSeconds = rampSeconds;
+    smoothingType = type;
 }
 
 // reset the DSP state
-void OverdriveDSP::reset()
-{
-    // HPF history
-    hp_inputHistory1 = 0.0f;
-    hp_inputHistory2 = 0.0f;
-    hp_outputHistory1 = 0.0f;
-    hp_outputHistory2 = 0.0f;
-
-    // Post-LPF history
-    postLPF_inputHistory1 = 0.0f;
-    postLPF_inputHistory2 = 0.0f;
-    postLPF_outputHistory1 = 0.0f;
-    postLPF_outputHistory2 = 0.0f;
-
-    // LPF history
-    lp_inputHistory1 = 0.0f;
-    lp_inputHistory2 = 0.0f;
-    lp_outputHistory1 = 0.0f;
-    lp_outputHistory2 = 0.0f;
-
-    previousTone = 0.0f;
-}
-
-// helper function for soft clipping
-float OverdriveDSP::tanhClip(float input)
-{
-    return tanh(input);
-}
-
-float OverdriveDSP::applyLPF(float input)
-{
-    float output = lp_b0 * input + lp_b1 * lp_inputHistory1 + lp_b2 * lp_inputHistory2
-                   - lp_a1 * lp_outputHistory1 - lp_a2 * lp_outputHistory2;
-    
-    // update history
-    lp_inputHistory2 = lp_inputHistory1;
-    lp_inputHistory1 = input;
-    lp_outputHistory2 = lp_outputHistory1;
-    lp_outputHistory1 = output;
-
-    return output;
-}
-
-// POST LPF
-float OverdriveDSP::applyPostLPF(float input)
-{
-    float output = post_b0 * input + post_b1 * postLPF_inputHistory1 + post_b2 * postLPF_inputHistory2
-                   - post_a1 * postLPF_outputHistory1 - post_a2 * postLPF_outputHistory2;
-    
-    // update history
-    postLPF_inputHistory2 = postLPF_inputHistory1;
-    postLPF_inputHistory1 = input;
-    postLPF_outputHistory2 = postLPF_outputHistory1;
-    postLPF_outputHistory1 = output;
-
-    return output;
-}
-
-// helper to update post low-pass filter coefficients
-void OverdriveDSP::updatePostLPFCoefficients()
-{
-    float cutoffFreq = 7000.0f;  // Fixed at 7 kHz
-    float Q = 0.707f;
-    
-    float w0 = 2.0f * 3.14159265f * cutoffFreq / sampleRate;
-    float sinW0 = std::sin(w0);
-    float cosW0 = std::cos(w0);
-    float alpha = sinW0 / (2.0f * Q);
-    
-    // Apply LPF formulas
-    post_b0 = (1.0f - cosW0) / 2.0f;
-    post_b1 = 1.0f - cosW0;
-    post_b2 = (1.0f - cosW0) / 2.0f;
-    post_a1 = -2.0f * cosW0;
-    post_a2 = 1.0f - alpha;
-    
-    // Normalize
-    float a0 = 1.0f + alpha;
-    post_b0 /= a0;
-    post_b1 /= a0;
-    post_b2 /= a0;
-    post_a1 /= a0;
-    post_a2 /= a0;
-}
-
-// helper to update low-pass filter coefficients
-void OverdriveDSP::updateLPFCoefficients(float tone)
-{
-    float cutoffFreq = tone;  // Hz
-    float Q = 0.707f;          // Standard rolloff
-    
-    // biquad cookbook formulas
-    float w0 = 2.0f * 3.14159265f * cutoffFreq / sampleRate;
-    float sinW0 = std::sin(w0);
-    float cosW0 = std::cos(w0);
-    float alpha = sinW0 / (2.0f * Q);
-        
-    // Apply LPF formulas:
-    lp_b0 = (1.0f - cosW0) / 2.0f;
-    lp_b1 = 1.0f - cosW0;
-    lp_b2 = (1.0f - cosW0) / 2.0f;
-    lp_a1 = -2.0f * cosW0;
-    lp_a2 = 1.0f - alpha;
-    
-    // normalize (divide by a0)
-    float a0 = 1.0f + alpha;
-    lp_b0 /= a0;
-    lp_b1 /= a0;
-    lp_b2 /= a0;
-    lp_a1 /= a0;
-    lp_a2 /= a0;
-}
-
-// HPF
-float OverdriveDSP::applyHPF(float input)
-{
-    float output = hp_b0 * input + hp_b1 * hp_inputHistory1 + hp_b2 * hp_inputHistory2
-                   - hp_a1 * hp_outputHistory1 - hp_a2 * hp_outputHistory2;
-
-    // update history
-    hp_inputHistory2 = hp_inputHistory1;
-    hp_inputHistory1 = input;
-    hp_outputHistory2 = hp_outputHistory1;
-    hp_outputHistory1 = output;
-
-    return output;
-}
-
-// helper to update high-pass filter coefficients
-void OverdriveDSP::updateHPFCoefficients()
-{
-    float cutOffFreq = 720.0f; // Hz
-    float Q = 0.707f;
-
-    float w0 = 2.0f * 3.14159265f * cutOffFreq / sampleRate;
-    float sinW0 = std::sin(w0);
-    float cosW0 = std::cos(w0);
-    float alpha = sinW0 / (2.0f * Q);
-
-    // HPF formulas
-    hp_b0 = (1.0f + cosW0) / 2.0f;
-    hp_b1 = -(1.0f + cosW0);
-    hp_b2 = (1.0f + cosW0) / 2.0f;
-    hp_a1 = -2.0f * cosW0;
-    hp_a2 = 1.0f - alpha;
-
-    // normalize
-    float a0 = 1.0f + alpha;
-    hp_b0 /= a0;
-    hp_b1 /= a0;
-    hp_b2 /= a0;
-    hp_a1 /= a0;
-    hp_a2 /= a0;
+template <typename Sample>
+void OverdriveDSP<Sample>::reset()
+{
+    monoGroup.hpf.reset();
+    monoGroup.lpf.reset();
+    monoGroup.adaa.reset();
+    pairGroup.hpf.reset();
+    pairGroup.lpf.reset();
+    pairGroup.adaa.reset();
+
+    for (auto& group : laneGroups)
+    {
+        group.hpf.reset();
+        group.lpf.reset();
+        group.adaa.reset();
+    }
+
+    smoothersPrimed = false;
+    silent = false;
+    programFadeRemaining = 0;
+
+    envelopeLevel = 0.0f;
+    driveModulation = 1.0f;
+    toneModulation = 1.0f;
+}
+
+// touch-sensitive mode depths, from the next process() call on
+template <typename Sample>
+void OverdriveDSP<Sample>::setEnvelopeModulation(float driveDepth, float toneDepth)
+{
+    envelopeDriveDepth = driveDepth;
+    envelopeToneDepth = toneDepth;
+}
+
+// build a snapshot for the prepared sample rate
+template <typename Sample>
+typename OverdriveDSP<Sample>::Snapshot OverdriveDSP<Sample>::makeSnapshot(float drive, float tone, float level) const
+{
+    Snapshot snapshot;
+    snapshot.drive = drive;
+    snapshot.tone = tone;
+    snapshot.level = level;
+    snapshot.driveGain = driveToGain(drive);
+    snapshot.levelGain = levelToGain(level);
+    snapshot.toneCoefficients = BiquadCoefficients<Sample>::makeLowPass(sampleRate, tone, filterQ);
+    snapshot.toneForm = BiquadBlockForm::make(snapshot.toneCoefficients);
+    return snapshot;
+}
+
+// jump to a snapshot, crossfading from the current sound
+template <typename Sample>
+void OverdriveDSP<Sample>::applySnapshot(const Snapshot& snapshot)
+{
+    if (programFadeRemaining > 0)
+    {
+        deferredSnapshot = snapshot;
+        snapshotDeferred = true;
+        return;
+    }
+
+    // the outgoing program keeps its state and holds its current gains and tone;
+    // after a reset or in silence there is nothing audible to fade from
+    if (smoothersPrimed && !silent)
+    {
+        fadeMonoGroup = monoGroup;
+        fadePairGroup = pairGroup;
+        for (std::size_t g = 0; g < laneGroups.size(); ++g)
+            fadeLaneGroups[g] = laneGroups[g];
+
+        ControlSegment held;
+        held.driveGain = static_cast<Sample>(driveSmoother.getCurrent() * driveModulation * fixedGain);
+        held.driveStep = Sample(0);
+        held.levelGain = static_cast<Sample>(levelSmoother.getCurrent());
+        held.levelStep = Sample(0);
+        held.toneMoves = false;
+        held.toneTarget = toneCoefficients;
+        fadeSegments.fill(held);
+
+        programFadeRemaining = programFadeSamples;
+    }
+
+    // the incoming program starts at its values, its tone coefficients and the
+    // mono group's look-ahead form come precomputed
+    driveSmoother.snapToTarget(snapshot.driveGain);
+    levelSmoother.snapToTarget(snapshot.levelGain);
+    toneSmoother.snapToTarget(snapshot.tone);
+
+    toneCoefficients = snapshot.toneCoefficients;
+    coefficientTone = snapshot.tone;
+    monoGroup.lpf.setCoefficients(toneSection, toneCoefficients, snapshot.toneForm);
+    pairGroup.lpf.setCoefficients(toneSection, toneCoefficients);
+    for (auto& group : laneGroups)
+        group.lpf.setCoefficients(toneSection, toneCoefficients);
+
+    // processBlock() then finds its targets already reached
+    setParameters(snapshot.drive, snapshot.tone, snapshot.level);
+    smoothersPrimed = true;
+}
+
+// a program change held back by applySnapshot()
+template <typename Sample>
+void OverdriveDSP<Sample>::applyDeferredSnapshot()
+{
+    if (!snapshotDeferred || programFadeRemaining > 0)
+        return;
+
+    snapshotDeferred = false;
+    applySnapshot(deferredSnapshot);
+}
+
+// true when the whole block can be replaced by silence
+template <typename Sample>
+bool OverdriveDSP<Sample>::isBlockSilent(const Sample* const* channels, int numChannels, int numSamples) const
+{
+    // worst-case gain of the chain, the clipper and the Q = 0.707 filters never add any
+    const float levelGain = std::max(levelSmoother.getCurrent(), levelSmoother.getTarget());
+    float driveGain = std::max(driveSmoother.getCurrent(), driveSmoother.getTarget()) * fixedGain;
+
+    // a touch-sensitive drive may rise by its full depth before the next check
+    if (envelopeDriveDepth > 0.0f || driveModulation > 1.0f)
+        driveGain *= std::max(driveModulation, driveToGain(std::max(envelopeDriveDepth, 0.0f)));
+
+    // states are cheap to check, so the input is only scanned once they have decayed
+    if (!silent)
+    {
+        const float stateLimit = silenceThreshold / levelGain;
+        if (!monoGroup.hpf.isQuiet(stateLimit) || !monoGroup.lpf.isQuiet(stateLimit))
+            return false;
+        if (!pairGroup.hpf.isQuiet(stateLimit) || !pairGroup.lpf.isQuiet(stateLimit))
+            return false;
+
+        for (const auto& group : laneGroups)
+        {
+            if (!group.hpf.isQuiet(stateLimit) || !group.lpf.isQuiet(stateLimit))
+                return false;
+        }
+    }
+
+    const float inputLimit = silenceThreshold / (driveGain * levelGain);
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        // branch-free reduction so the scan vectorizes
+        const Sample* input = channels[channel];
+        const Sample limit = static_cast<Sample>(inputLimit);
+        bool loud = false;
+        for (int i = 0; i < numSamples; ++i)
+            loud |= std::abs(input[i]) >= limit;
+
+        if (loud)
+            return false;
+    }
+
+    return true;
+}
+
+// zero the block and bring smoothers and filters to rest without processing
+template <typename Sample>
+void OverdriveDSP<Sample>::skipSilentBlock(Sample* const* channels, int numChannels, int numSamples, float tone)
+{
+    for (int channel = 0; channel < numChannels; ++channel)
+        std::fill(channels[channel], channels[channel] + numSamples, Sample(0));
+
+    // nothing is audible, so ramps jump straight to their targets and the
+    // envelope falls back to rest
+    envelopeLevel = 0.0f;
+    driveModulation = 1.0f;
+    toneModulation = 1.0f;
+    driveSmoother.snapToTarget(driveSmoother.getTarget());
+    levelSmoother.snapToTarget(levelSmoother.getTarget());
+    toneSmoother.snapToTarget(tone);
+    if (tone != coefficientTone)
+        setToneCoefficients(tone);
+
+    // the remaining state is inaudible, clear it so the next signal starts clean
+    if (!silent)
+    {
+        monoGroup.hpf.reset();
+        monoGroup.lpf.reset();
+        monoGroup.adaa.reset();
+        pairGroup.hpf.reset();
+        pairGroup.lpf.reset();
+        pairGroup.adaa.reset();
+        for (auto& group : laneGroups)
+        {
+            group.hpf.reset();
+            group.lpf.reset();
+            group.adaa.reset();
+        }
+        silent = true;
+    }
+}
+
+// advance the smoothers once per control segment of the chunk
+template <typename Sample>
+void OverdriveDSP<Sample>::computeControlSegments(int numFrames)
+{
+    for (int k = 0, start = 0; start < numFrames; ++k, start += controlInterval)
+    {
+        int segmentLength = std::min(controlInterval, numFrames - start);
+        Sample segmentScale = Sample(1) / static_cast<Sample>(segmentLength);
+        ControlSegment& c = controlSegments[k];
+
+        // gains ramp linearly between the control-rate smoother values
+        const Sample gain = static_cast<Sample>(fixedGain);
+        c.driveGain = static_cast<Sample>(driveSmoother.getCurrent()) * gain;
+        c.driveStep = (static_cast<Sample>(driveSmoother.advance(segmentLength)) * gain - c.driveGain) * segmentScale;
+        c.levelGain = static_cast<Sample>(levelSmoother.getCurrent());
+        c.levelStep = (static_cast<Sample>(levelSmoother.advance(segmentLength)) - c.levelGain) * segmentScale;
+
+        // tone coefficients are computed at most once per segment and interpolated per sample
+        float segmentTone = toneSmoother.advance(segmentLength);
+        c.toneMoves = segmentTone != coefficientTone;
+        if (c.toneMoves)
+        {
+            toneCoefficients = BiquadCoefficients<Sample>::makeLowPass(sampleRate, segmentTone, filterQ);
+            coefficientTone = segmentTone;
+        }
+        c.toneTarget = toneCoefficients;
+    }
+}
+
+// mean absolute input across the chunk, loudest channel, into a one-pole follower
+// whose attack and release are scaled to the chunk length
+template <typename Sample>
+void OverdriveDSP<Sample>::followEnvelope(const Sample* const* channels, int numChannels, int start, int numFrames,
+                                          float& driveFactor, float& toneFactor)
+{
+    float level = 0.0f;
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const Sample* input = channels[channel] + start;
+        Sample sum = 0;
+        for (int i = 0; i < numFrames; ++i)
+            sum += std::abs(input[i]);
+        level = std::max(level, static_cast<float>(sum) / static_cast<float>(numFrames));
+    }
+
+    const bool rising = level > envelopeLevel;
+    float coefficient = rising ? envelopeAttack : envelopeRelease;
+    if (numFrames != chunkFrames)
+    {
+        const float timeConstant = rising ? envelopeAttackSeconds : envelopeReleaseSeconds;
+        coefficient = 1.0f - std::exp(-static_cast<float>(numFrames) / (timeConstant * sampleRate));
+    }
+    envelopeLevel += coefficient * (level - envelopeLevel);
+
+    // position between the floor and full modulation, in dB
+    const float levelDb = 20.0f * std::log10(std::max(envelopeLevel, 1.0e-9f));
+    const float amount = std::clamp((levelDb - envelopeFloorDb) / envelopeRangeDb, 0.0f, 1.0f);
+
+    // exactly 1 at zero depth, so switching the mode off settles back onto the plain path
+    driveFactor = driveToGain(envelopeDriveDepth * amount);
+    toneFactor = std::exp2(envelopeToneDepth * amount);
+}
+
+// drive ramps segment by segment from the last chunk's factor to the new one;
+// the tone is designed once for the chunk's end and the coefficients are
+// interpolated towards it segment by segment, and per sample within each
+template <typename Sample>
+void OverdriveDSP<Sample>::computeModulatedSegments(int numFrames, float driveFactor, float toneFactor)
+{
+    const int numSegments = (numFrames + controlInterval - 1) / controlInterval;
+    const Sample gain = static_cast<Sample>(fixedGain);
+    Sample driveGain = static_cast<Sample>(driveSmoother.getCurrent() * driveModulation) * gain;
+    float segmentTone = toneSmoother.getCurrent();
+
+    for (int k = 0, start = 0; start < numFrames; ++k, start += controlInterval)
+    {
+        int segmentLength = std::min(controlInterval, numFrames - start);
+        Sample segmentScale = Sample(1) / static_cast<Sample>(segmentLength);
+        ControlSegment& c = controlSegments[k];
+
+        const float fraction = static_cast<float>(k + 1) / static_cast<float>(numSegments);
+        const float factor = driveModulation + fraction * (driveFactor - driveModulation);
+        c.driveGain = driveGain;
+        driveGain = static_cast<Sample>(driveSmoother.advance(segmentLength) * factor) * gain;
+        c.driveStep = (driveGain - c.driveGain) * segmentScale;
+
+        c.levelGain = static_cast<Sample>(levelSmoother.getCurrent());
+        c.levelStep = (static_cast<Sample>(levelSmoother.advance(segmentLength)) - c.levelGain) * segmentScale;
+
+        segmentTone = toneSmoother.advance(segmentLength);
+    }
+
+    driveModulation = driveFactor;
+    toneModulation = toneFactor;
+
+    // small modulation moves are held back until they add up to a step, so a
+    // steady envelope keeps the tone filter on its fast static path; knob moves
+    // without modulation are followed exactly
+    const float chunkTone = std::clamp(segmentTone * toneFactor, modulatedToneMin, 0.45f * sampleRate);
+    const float toneRatio = chunkTone / coefficientTone;
+    const bool toneMoves = toneFactor == 1.0f ? chunkTone != coefficientTone
+                                              : toneRatio > modulatedToneStep || toneRatio * modulatedToneStep < 1.0f;
+    const BiquadCoefficients<Sample> from = toneCoefficients;
+    if (toneMoves)
+    {
+        toneCoefficients = BiquadCoefficients<Sample>::makeLowPass(sampleRate, chunkTone, filterQ);
+        coefficientTone = chunkTone;
+    }
+
+    for (int k = 0; k < numSegments; ++k)
+    {
+        ControlSegment& c = controlSegments[k];
+        const Sample fraction = static_cast<Sample>(k + 1) / static_cast<Sample>(numSegments);
+        c.toneMoves = toneMoves;
+        c.toneTarget.b0 = from.b0 + fraction * (toneCoefficients.b0 - from.b0);
+        c.toneTarget.b1 = from.b1 + fraction * (toneCoefficients.b1 - from.b1);
+        c.toneTarget.b2 = from.b2 + fraction * (toneCoefficients.b2 - from.b2);
+        c.toneTarget.a1 = from.a1 + fraction * (toneCoefficients.a1 - from.a1);
+        c.toneTarget.a2 = from.a2 + fraction * (toneCoefficients.a2 - from.a2);
+    }
+
+    // the interpolation can round off the design, the chunk has to end on it
+    // exactly or a tone returning to rest never matches the plain path again
+    controlSegments[numSegments - 1].toneTarget = toneCoefficients;
+}
+
+// the look-ahead form only exists for single-lane cascades
+template <typename Sample>
+template <int Lanes, int Sections>
+void OverdriveDSP<Sample>::processFilterSection(BiquadCascade<Sections, Lanes, Sample>& cascade, int section,
+                                                Sample* frames, int numFrames)
+{
+    if constexpr (Lanes == 1)
+    {
+        if (filterStructure == FilterStructure::LookAhead)
+        {
+            cascade.processSectionBlockLookAhead(section, frames, numFrames);
+            return;
+        }
+    }
+
+    cascade.processSectionBlock(section, frames, numFrames);
+}
+
+// each stage runs as its own loop over the chunk, Lanes channels per frame
+template <typename Sample>
+template <int Lanes>
+void OverdriveDSP<Sample>::processGroup(ChannelGroup<Lanes>& group, const ControlSegment* segments, Sample* frames, int numFrames)
+{
+    // apply fixed gain and drive
+    {
+        ODPEDAL_TRACE_SCOPE("drive");
+        for (int k = 0, start = 0; start < numFrames; ++k, start += controlInterval)
+        {
+            int segmentLength = std::min(controlInterval, numFrames - start);
+            Sample* segment = frames + start * Lanes;
+            Sample gain = segments[k].driveGain;
+            Sample gainStep = segments[k].driveStep;
+
+            for (int i = 0; i < segmentLength; ++i)
+            {
+                gain += gainStep;
+                for (int lane = 0; lane < Lanes; ++lane)
+                    segment[i * Lanes + lane] *= gain;
+            }
+        }
+    }
+
+    // Apply HPF
+    {
+        ODPEDAL_TRACE_SCOPE("hpf");
+        processFilterSection(group.hpf, 0, frames, numFrames);
+    }
+
+    // drive into the clipper, for the editor's clip indicator
+    clipperPeak = std::max(clipperPeak, peakMagnitude(frames, numFrames * Lanes));
+
+    // soft clipping, the stateless kernels are element-wise so lanes need no
+    // special care; the ADAA modes keep a history per lane
+    {
+        ODPEDAL_TRACE_SCOPE("clipper");
+        if (saturator == SaturatorType::Adaa1)
+            group.adaa.processFirstOrder(frames, numFrames);
+        else if (saturator == SaturatorType::Adaa2)
+            group.adaa.processSecondOrder(frames, numFrames);
+        else
+            Saturators::processBlock(saturator, frames, numFrames * Lanes);
+    }
+
+    // post LPF
+    {
+        ODPEDAL_TRACE_SCOPE("post_lpf");
+        processFilterSection(group.lpf, postLPFSection, frames, numFrames);
+    }
+
+    // apply LPF
+    {
+        ODPEDAL_TRACE_SCOPE("tone_lpf");
+        for (int k = 0, start = 0; start < numFrames; ++k, start += controlInterval)
+        {
+            int segmentLength = std::min(controlInterval, numFrames - start);
+            Sample* segment = frames + start * Lanes;
+
+            if (segments[k].toneMoves)
+                group.lpf.processSectionBlockRamped(toneSection, segment, segmentLength, segments[k].toneTarget);
+            else
+                processFilterSection(group.lpf, toneSection, segment, segmentLength);
+        }
+    }
+
+    // apply output level
+    {
+        ODPEDAL_TRACE_SCOPE("level");
+        for (int k = 0, start = 0; start < numFrames; ++k, start += controlInterval)
+        {
+            int segmentLength = std::min(controlInterval, numFrames - start);
+            Sample* segment = frames + start * Lanes;
+            Sample gain = segments[k].levelGain;
+            Sample gainStep = segments[k].levelStep;
+
+            for (int i = 0; i < segmentLength; ++i)
+            {
+                gain += gainStep;
+                for (int lane = 0; lane < Lanes; ++lane)
+                    segment[i * Lanes + lane] *= gain;
+            }
+        }
+    }
+}
+
+// linear crossfade, the outgoing program's weight falls to zero over programFadeSamples
+template <typename Sample>
+template <int Lanes>
+void OverdriveDSP<Sample>::mixFade(const Sample* outgoing, Sample* frames, int numFrames, int fadeOffset) const
+{
+    const Sample step = Sample(1) / static_cast<Sample>(programFadeSamples);
+    const int fadeFrames = std::min(numFrames, programFadeSamples - fadeOffset);
+    Sample weight = static_cast<Sample>(fadeOffset) * step;
+
+    for (int i = 0; i < fadeFrames; ++i)
+    {
+        weight += step;
+        for (int lane = 0; lane < Lanes; ++lane)
+        {
+            const int n = i * Lanes + lane;
+            frames[n] = outgoing[n] + weight * (frames[n] - outgoing[n]);
+        }
+    }
+}
+
+// ramp targets for the next processBlock()
+template <typename Sample>
+void OverdriveDSP<Sample>::setParameters(float drive, float tone, float level)
+{
+    driveParameter = drive;
+    toneParameter = tone;
+    levelParameter = level;
+}
+
+// audio processing loop (mono)
+template <typename Sample>
+void OverdriveDSP<Sample>::process(Sample* buffer, int numSamples, float drive, float tone, float level)
+{
+    Sample* channels[1] = { buffer };
+    process(channels, 1, numSamples, drive, tone, level);
 }
 
 // audio processing loop
-void OverdriveDSP::process(float* buffer, int numSamples, float drive, float tone, float level)
+template <typename Sample>
+void OverdriveDSP<Sample>::process(Sample* const* channels, int numChannels, int numSamples, float drive, float tone, float level)
 {
+    // decaying filter states must not fall into the slow denormal range
+    ScopedFlushDenormals flushDenormals;
+    ODPEDAL_TRACE_SCOPE("OverdriveDSP::process");
+    ODPEDAL_REALTIME_SCOPE("OverdriveDSP::process");
+
+    numChannels = std::min(numChannels, preparedChannels);
+    clipperPeak = 0.0f;
+
+    // a program change that waited for the last crossfade takes over first
+    applyDeferredSnapshot();
+
     // convert dB parameters to linear
-    float driveLinear = std::pow(10.0f, (drive / 20.0f) * driveExponent);
-    float levelLinear = std::pow(10.0f, level / 20.0f);
+    float driveLinear = driveToGain(drive);
+    float levelLinear = levelToGain(level);
+
+    if (!smoothersPrimed)
+    {
+        // nothing to glide from after prepare/reset
+        driveSmoother.snapToTarget(driveLinear);
+        levelSmoother.snapToTarget(levelLinear);
+        toneSmoother.snapToTarget(tone);
+        setToneCoefficients(tone);
+        smoothersPrimed = true;
+    }
+    else
+    {
+        driveSmoother.setTarget(driveLinear);
+        levelSmoother.setTarget(levelLinear);
+        toneSmoother.setTarget(tone);
+    }
+
+    // idle tracks skip the per-sample chain entirely, once any program crossfade is over
+    if (programFadeRemaining == 0 && isBlockSilent(channels, numChannels, numSamples))
+    {
+        ODPEDAL_TRACE_SCOPE("silence_skip");
+        skipSilentBlock(channels, numChannels, numSamples, tone);
+        return;
+    }
+
+    silent = false;
 
-    for (int i = 0; i < numSamples; ++i)
+    for (int start = 0; start < numSamples; start += chunkFrames)
     {
-        // apply fixed gain
-        float inputSample = buffer[i] * fixedGain;
+        int numFrames = std::min(chunkFrames, numSamples - start);
+
+        // or as soon as that crossfade ends within this block
+        applyDeferredSnapshot();
 
-        // apply drive
-        float driveSample = inputSample * driveLinear;
+        // the touch-sensitive mode measures each chunk before it is processed
+        if (isModulating())
+        {
+            float driveFactor, toneFactor;
+            followEnvelope(channels, numChannels, start, numFrames, driveFactor, toneFactor);
+            computeModulatedSegments(numFrames, driveFactor, toneFactor);
+        }
+        else
+        {
+            computeControlSegments(numFrames);
+        }
 
-        // Apply HPF
-        float hpfSample = applyHPF(driveSample);
+        // during a program crossfade each group also runs the outgoing program on a copy
+        const bool fading = programFadeRemaining > 0;
+        const int fadeOffset = programFadeSamples - programFadeRemaining;
+        programFadeRemaining = std::max(0, programFadeRemaining - numFrames);
 
-        // soft clipping
-        float clippedSample = tanhClip(hpfSample);
+        if (numChannels == 1)
+        {
+            Sample* frames = channels[0] + start;
+            if (fading)
+            {
+                std::copy(frames, frames + numFrames, fadeScratch);
+                processGroup(fadeMonoGroup, fadeSegments.data(), fadeScratch, numFrames);
+            }
 
-        // post LPF
-        float postLPFSample = applyPostLPF(clippedSample);
+            processGroup(monoGroup, controlSegments.data(), frames, numFrames);
 
-        if (tone != previousTone) {
-            updateLPFCoefficients(tone);
-            previousTone = tone;
+            if (fading)
+                mixFade<1>(fadeScratch, frames, numFrames, fadeOffset);
+            continue;
         }
 
-        // apply LPF
-        float toneSample = applyLPF(postLPFSample);
+        if (laneGroups.empty())
+        {
+            processInterleaved(pairGroup, fadePairGroup, channels, 0, numChannels, start, numFrames, fading, fadeOffset);
+            continue;
+        }
 
-        // apply output level
-        buffer[i] = toneSample * levelLinear;
+        for (int first = 0, g = 0; first < numChannels; first += laneWidth, ++g)
+            processInterleaved(laneGroups[g], fadeLaneGroups[g], channels, first, std::min(laneWidth, numChannels - first),
+                               start, numFrames, fading, fadeOffset);
     }
 }
+
+// one chunk of up to Lanes channels through a lane group
+template <typename Sample>
+template <int Lanes>
+void OverdriveDSP<Sample>::processInterleaved(ChannelGroup<Lanes>& group, ChannelGroup<Lanes>& fadeGroup,
+                                              Sample* const* channels, int first, int lanesUsed, int start,
+                                              int numFrames, bool fading, int fadeOffset)
+{
+    // interleave channels into lanes, unused lanes carry silence
+    for (int lane = 0; lane < Lanes; ++lane)
+    {
+        const Sample* source = lane < lanesUsed ? channels[first + lane] + start : nullptr;
+        for (int i = 0; i < numFrames; ++i)
+            scratch[i * Lanes + lane] = source != nullptr ? source[i] : Sample(0);
+    }
+
+    if (fading)
+    {
+        std::copy(scratch, scratch + numFrames * Lanes, fadeScratch);
+        processGroup(fadeGroup, fadeSegments.data(), fadeScratch, numFrames);
+    }
+
+    processGroup(group, controlSegments.data(), scratch, numFrames);
+
+    if (fading)
+        mixFade<Lanes>(fadeScratch, scratch, numFrames, fadeOffset);
+
+    // de-interleave back into the channel buffers
+    for (int lane = 0; lane < lanesUsed; ++lane)
+    {
+        Sample* destination = channels[first + lane] + start;
+        for (int i = 0; i < numFrames; ++i)
+            destination[i] = scratch[i * Lanes + lane];
+    }
+}
+
+template class OverdriveDSP<float>;
+template class OverdriveDSP<double>;
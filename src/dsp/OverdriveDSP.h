@@ -3,68 +3,253 @@
 # include <cmath>
 # include <algorithm>
 # include <array>
-
+# include <vector>
+
+# include "Biquad.h"
+# include "DenormalGuard.h"
+# include "Saturators.h"
+# include "ParameterSmoother.h"
+# include "RealtimeCheck.h"
+# include "TanhAdaa.h"
+# include "TraceRecorder.h"
+
+// the overdrive chain, instantiated for float and double samples. parameters,
+// smoothing and the sample rate stay float in both; buffers, filter state,
+// coefficients and gain ramps run in Sample precision.
+template <typename Sample>
 class OverdriveDSP
 {
     public:
+        using SampleType = Sample;
+
         // constructor
         OverdriveDSP();
 
-        // prepare the DSP with the given sample rate
-        void prepare(float sampleRate);
-
-        // audio processing loop
-        void process(float* buffer, int numSamples, float drive, float tone, float level);
+        // prepare the DSP with the given sample rate, channel count and clipper kernel
+        void prepare(float sampleRate, int numChannels = 1, SaturatorType saturatorType = SaturatorType::Exact);
+
+        // audio processing loop (mono), drive/tone/level are ramp targets for this block
+        void process(Sample* buffer, int numSamples, float drive, float tone, float level);
+
+        // audio processing loop (any channel count up to the prepared one), all
+        // channels share the parameters but keep their own filter state
+        void process(Sample* const* channels, int numChannels, int numSamples, float drive, float tone, float level);
+
+        // PedalStage interface (PedalChain.h): drive/tone/level are held until the
+        // next processBlock(), which ramps to them like process() does
+        void setParameters(float drive, float tone, float level);
+        void processBlock(Sample* const* channels, int numChannels, int numSamples)
+        {
+            process(channels, numChannels, numSamples, driveParameter, toneParameter, levelParameter);
+        }
+
+        // a program's parameters together with everything process() would derive
+        // from them, so a program change needs no coefficient design on the audio thread
+        struct Snapshot
+        {
+            float drive = 0.0f;      // dB
+            float tone = 3000.0f;    // Hz
+            float level = 0.0f;      // dB
+            float driveGain = 1.0f;  // linear, without fixedGain
+            float levelGain = 1.0f;  // linear
+            BiquadCoefficients<Sample> toneCoefficients;
+            BiquadBlockForm toneForm;   // look-ahead form of toneCoefficients for the mono group
+        };
+
+        // build a snapshot for the prepared sample rate, call off the audio thread
+        Snapshot makeSnapshot(float drive, float tone, float level) const;
+
+        // jump to a snapshot without ramps; the previous sound keeps running on a
+        // copy of the filter state and is crossfaded out over programFadeSeconds.
+        // a snapshot applied during a crossfade waits for it to end, and only the
+        // latest of those is kept
+        void applySnapshot(const Snapshot& snapshot);
+
+        // touch-sensitive mode: an envelope follower on the input adds up to
+        // driveDepth dB of drive and moves the tone cutoff by up to toneDepth
+        // octaves at full envelope. the modulation is updated once per chunk, the
+        // drive gain ramps and the tone coefficients are interpolated across it.
+        // 0, 0 turns the mode off
+        void setEnvelopeModulation(float driveDepth, float toneDepth);
+
+        // parameter ramp shape and length, applied on the next prepare()
+        void setSmoothing(float rampSeconds, SmoothingType type);
+
+        // how the mono channel runs its filters, from the next process() call on.
+        // channels in lane groups always run serially, their lanes already fill the SIMD registers
+        void setFilterStructure(FilterStructure structure) { filterStructure = structure; }
 
         // reset the DSP state
         void reset();
 
+        // largest magnitude fed into the clipper during the last process() call,
+        // above 1 the tanh stage is audibly saturating
+        float getClipperPeak() const { return clipperPeak; }
+
     private:
         // DSP state variables
         float sampleRate = 44100.0f;
-        float previousTone = 0.0f;
         float fixedGain = 2.0f;
         float driveExponent = 1.5f;
 
-        // POST LPF
-        float postLPF_inputHistory1 = 0.0f;   // POST LPF x[n-1]
-        float postLPF_inputHistory2 = 0.0f;   // POST LPF x[n-2]
-        float postLPF_outputHistory1 = 0.0f;  // POST LPF y[n-1]
-        float postLPF_outputHistory2 = 0.0f;  // POST LPF y[n-2]
-
-        float post_b0 = 0.0f, post_b1 = 0.0f, post_b2 = 0.0f;
-        float post_a1 = 0.0f, post_a2 = 0.0f;
-
-        float applyPostLPF(float input);
-
-        void updatePostLPFCoefficients();
-
-        // LPF
-        float lp_inputHistory1 = 0.0f;   // LPF x[n-1]
-        float lp_inputHistory2 = 0.0f;   // LPF x[n-2]
-        float lp_outputHistory1 = 0.0f;  // LPF y[n-1]
-        float lp_outputHistory2 = 0.0f;  // LPF y[n-2]
-        
-        float lp_b0 = 0.0f, lp_b1 = 0.0f, lp_b2 = 0.0f;
-        float lp_a1 = 0.0f, lp_a2 = 0.0f;
-
-        float applyLPF(float input);
-
-        void updateLPFCoefficients(float tone);
-
-        // HPF
-        float hp_inputHistory1 = 0.0f;   // HPF x[n-1]
-        float hp_inputHistory2 = 0.0f;   // HPF x[n-2]
-        float hp_outputHistory1 = 0.0f;  // HPF y[n-1]
-        float hp_outputHistory2 = 0.0f;  // HPF y[n-2]
-
-        float hp_b0 = 0.0f, hp_b1 = 0.0f, hp_b2 = 0.0f;
-        float hp_a1 = 0.0f, hp_a2 = 0.0f;
-
-        float applyHPF(float input);
-
-        void updateHPFCoefficients();
-
-        // tanh clip
-        float tanhClip(float input);
+        // clipper kernel selected in prepare()
+        SaturatorType saturator = SaturatorType::Exact;
+        float clipperPeak = 0.0f;
+
+        // targets for processBlock(), set by setParameters()
+        float driveParameter = 0.0f;      // dB
+        float toneParameter = 3000.0f;    // Hz
+        float levelParameter = 0.0f;      // dB
+
+        // parameter smoothing, advanced once per control segment
+        static constexpr int controlInterval = 32;
+        float smoothingSeconds = 0.02f;
+        SmoothingType smoothingType = SmoothingType::Linear;
+        ParameterSmoother driveSmoother;   // linear drive gain
+        ParameterSmoother levelSmoother;   // linear output gain
+        ParameterSmoother toneSmoother;    // tone cutoff in Hz
+        bool smoothersPrimed = false;      // first block after reset jumps to its targets
+        float coefficientTone = 0.0f;      // cutoff the current tone coefficients belong to
+
+        // program change crossfade: the outgoing program runs on copies of the
+        // channel groups at its last gains and tone until the fade is over
+        static constexpr float programFadeSeconds = 0.01f;
+        int programFadeSamples = 1;
+        int programFadeRemaining = 0;
+
+        // a program change that arrived mid-fade; replacing the outgoing copy
+        // then would cut off a program that is still partly audible
+        Snapshot deferredSnapshot;
+        bool snapshotDeferred = false;
+
+        // touch-sensitive modulation from the input's mean absolute level; the
+        // factors are the ones the last chunk ended on, 1 when nothing is modulated
+        static constexpr float envelopeAttackSeconds = 0.005f;
+        static constexpr float envelopeReleaseSeconds = 0.15f;
+        static constexpr float envelopeFloorDb = -50.0f;   // softer playing is not modulated
+        static constexpr float envelopeRangeDb = 40.0f;    // full modulation this far above the floor
+        static constexpr float modulatedToneMin = 200.0f;  // Hz
+        static constexpr float modulatedToneStep = 1.0293f; // 1/24 octave, smaller moves keep the coefficients
+        float envelopeDriveDepth = 0.0f;   // dB
+        float envelopeToneDepth = 0.0f;    // octaves
+        float envelopeAttack = 1.0f;       // follower coefficients for a full chunk
+        float envelopeRelease = 1.0f;
+        float envelopeLevel = 0.0f;
+        float driveModulation = 1.0f;
+        float toneModulation = 1.0f;
+
+        // filters
+        static constexpr float filterQ = 0.707f;
+        static constexpr float hpfCutoff = 720.0f;       // Hz
+        static constexpr float postLPFCutoff = 7000.0f;  // Hz, fixed
+        static constexpr int postLPFSection = 0;
+        static constexpr int toneSection = 1;
+        FilterStructure filterStructure = FilterStructure::Serial;
+
+        // silence fast path: once the input and every filter state would stay
+        // below this output-referred level (-120 dBFS), blocks are zero-filled
+        // without running the chain until signal returns
+        static constexpr float silenceThreshold = 1.0e-6f;
+        bool silent = false;
+
+        // per-channel filter state; channels beyond the first are processed
+        // laneWidth at a time, interleaved so each filter step covers them all.
+        // a stereo instance runs one 2-lane group instead, so it does not pay
+        // for two idle lanes
+        static constexpr int laneWidth = 4;
+        static constexpr int pairWidth = 2;
+
+        template <int Lanes>
+        struct ChannelGroup
+        {
+            BiquadCascade<1, Lanes, Sample> hpf;   // pre-clip high-pass
+            BiquadCascade<2, Lanes, Sample> lpf;   // post-clip fixed LPF, then tone LPF
+            TanhAdaa<Lanes> adaa;                  // clipper history for the ADAA modes
+        };
+
+        int preparedChannels = 1;
+        ChannelGroup<1> monoGroup;
+        ChannelGroup<pairWidth> pairGroup;
+        std::vector<ChannelGroup<laneWidth>> laneGroups;
+
+        // outgoing program during a crossfade, sized with the groups above
+        ChannelGroup<1> fadeMonoGroup;
+        ChannelGroup<pairWidth> fadePairGroup;
+        std::vector<ChannelGroup<laneWidth>> fadeLaneGroups;
+
+        // control values shared by every channel group, computed once per chunk
+        static constexpr int chunkFrames = 256;
+        static constexpr int segmentsPerChunk = chunkFrames / controlInterval;
+
+        struct ControlSegment
+        {
+            Sample driveGain, driveStep;   // includes fixedGain
+            Sample levelGain, levelStep;
+            bool toneMoves;
+            BiquadCoefficients<Sample> toneTarget;
+        };
+
+        std::array<ControlSegment, segmentsPerChunk> controlSegments;
+        std::array<ControlSegment, segmentsPerChunk> fadeSegments;   // held values of the outgoing program
+        BiquadCoefficients<Sample> toneCoefficients;
+
+        // interleave buffer for one lane group, and the outgoing program's copy of it
+        alignas(64) Sample scratch[chunkFrames * laneWidth];
+        alignas(64) Sample fadeScratch[chunkFrames * laneWidth];
+
+        // parameter values to linear gains, shared by process() and makeSnapshot()
+        // so a snapshot's gains match the ramp targets exactly
+        float driveToGain(float drive) const { return std::pow(10.0f, (drive / 20.0f) * driveExponent); }
+        static float levelToGain(float level) { return std::pow(10.0f, level / 20.0f); }
+
+        // helper to jump every channel group to a tone cutoff without a ramp
+        void setToneCoefficients(float tone);
+
+        // true when the whole block can be replaced by silence
+        bool isBlockSilent(const Sample* const* channels, int numChannels, int numSamples) const;
+
+        // zero the block and bring smoothers and filters to rest without processing
+        void skipSilentBlock(Sample* const* channels, int numChannels, int numSamples, float tone);
+
+        // advance the smoothers across one chunk
+        void computeControlSegments(int numFrames);
+
+        // true while the touch-sensitive mode is on or still returning to rest
+        bool isModulating() const
+        {
+            return envelopeDriveDepth != 0.0f || envelopeToneDepth != 0.0f || driveModulation != 1.0f || toneModulation != 1.0f;
+        }
+
+        // follow the input's envelope across one chunk, giving the drive gain and
+        // cutoff factors for its end
+        void followEnvelope(const Sample* const* channels, int numChannels, int start, int numFrames,
+                            float& driveFactor, float& toneFactor);
+
+        // computeControlSegments() with the modulation ramped in from the last chunk's factors
+        void computeModulatedSegments(int numFrames, float driveFactor, float toneFactor);
+
+        // one biquad section over a buffer in the selected structure
+        template <int Lanes, int Sections>
+        void processFilterSection(BiquadCascade<Sections, Lanes, Sample>& cascade, int section, Sample* frames, int numFrames);
+
+        // run every stage over one chunk of one channel group
+        template <int Lanes>
+        void processGroup(ChannelGroup<Lanes>& group, const ControlSegment* segments, Sample* frames, int numFrames);
+
+        // interleave Lanes channels from first into scratch, run them through a
+        // group (and the outgoing program's copy while fading) and write them back
+        template <int Lanes>
+        void processInterleaved(ChannelGroup<Lanes>& group, ChannelGroup<Lanes>& fadeGroup, Sample* const* channels,
+                                int first, int lanesUsed, int start, int numFrames, bool fading, int fadeOffset);
+
+        // switch to a deferred snapshot once the crossfade before it is over
+        void applyDeferredSnapshot();
+
+        // blend the outgoing program's output into frames, fadeOffset samples into the fade
+        template <int Lanes>
+        void mixFade(const Sample* outgoing, Sample* frames, int numFrames, int fadeOffset) const;
+
+        // set up coefficients of a channel group
+        template <int Lanes>
+        void prepareGroup(ChannelGroup<Lanes>& group);
 };
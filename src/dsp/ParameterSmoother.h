@@ -0,0 +1,80 @@
+# pragma once
+
+# include <cmath>
+# include <algorithm>
+
+// ramp shape used by ParameterSmoother
+enum class SmoothingType
+{
+    Linear,      // constant step, reaches the target exactly after the ramp time
+    Exponential  // one-pole glide, within -60 dB of the target after the ramp time
+};
+
+// control-rate parameter ramp. the owner advances it a whole segment at a time
+// and interpolates between segment endpoints, so no per-sample branching is needed.
+class ParameterSmoother
+{
+    public:
+        // set the ramp shape and length, resets the smoother to its target
+        void prepare(float sampleRate, float rampSeconds, SmoothingType type)
+        {
+            smoothingType = type;
+            rampSamples = std::max(1, static_cast<int>(std::lround(sampleRate * rampSeconds)));
+
+            // per-sample pole that leaves 0.001 of the distance after rampSamples
+            pole = std::exp(std::log(0.001f) / static_cast<float>(rampSamples));
+            snapToTarget(target);
+        }
+
+        // jump straight to a value, no ramp
+        void snapToTarget(float value)
+        {
+            current = value;
+            target = value;
+            remaining = 0;
+            step = 0.0f;
+        }
+
+        // start a ramp towards a new value
+        void setTarget(float newTarget)
+        {
+            if (newTarget == target)
+                return;
+
+            target = newTarget;
+            remaining = rampSamples;
+            step = (target - current) / static_cast<float>(rampSamples);
+        }
+
+        // move numSamples along the ramp and return the value reached
+        float advance(int numSamples)
+        {
+            if (remaining <= numSamples)
+            {
+                current = target;
+                remaining = 0;
+                return current;
+            }
+
+            if (smoothingType == SmoothingType::Linear)
+                current += step * static_cast<float>(numSamples);
+            else
+                current = target + (current - target) * std::pow(pole, static_cast<float>(numSamples));
+
+            remaining -= numSamples;
+            return current;
+        }
+
+        float getCurrent() const { return current; }
+        float getTarget() const { return target; }
+        bool isSmoothing() const { return remaining > 0; }
+
+    private:
+        SmoothingType smoothingType = SmoothingType::Linear;
+        float current = 0.0f;
+        float target = 0.0f;
+        float step = 0.0f;
+        float pole = 0.0f;
+        int rampSamples = 1;
+        int remaining = 0;
+};
@@ -0,0 +1,71 @@
+# pragma once
+
+# include <cstddef>
+# include <tuple>
+# include <type_traits>
+# include <utility>
+
+// a stage is anything that can be prepared, reset and run in place over a
+// block of non-interleaved SampleType channels. parameters are set on the stage
+// itself between blocks, so the chain never needs to know what they are.
+template <typename Stage>
+concept PedalStage = requires(Stage stage, float sampleRate, int numChannels,
+                              typename Stage::SampleType* const* channels, int numSamples)
+{
+    stage.prepare(sampleRate, numChannels);
+    stage.reset();
+    stage.processBlock(channels, numChannels, numSamples);
+};
+
+// a fixed chain of stages composed at compile time. stages are stored by value
+// and called through fold expressions over the concrete types, so every call
+// can inline: no virtual dispatch, no stage pointers, and a one-stage chain
+// costs the same as calling that stage directly.
+template <PedalStage... Stages>
+class PedalChain
+{
+    public:
+        static_assert(sizeof...(Stages) > 0, "PedalChain needs at least one stage");
+
+        static constexpr std::size_t numStages = sizeof...(Stages);
+
+        // every stage runs on the same buffers, so they share one sample type
+        using SampleType = typename std::tuple_element_t<0, std::tuple<Stages...>>::SampleType;
+        static_assert((std::is_same_v<typename Stages::SampleType, SampleType> && ...),
+                      "PedalChain stages must share one SampleType");
+
+        // prepare every stage, in chain order
+        void prepare(float sampleRate, int numChannels)
+        {
+            std::apply([&](Stages&... stage) { (stage.prepare(sampleRate, numChannels), ...); }, stages);
+        }
+
+        // reset every stage
+        void reset()
+        {
+            std::apply([](Stages&... stage) { (stage.reset(), ...); }, stages);
+        }
+
+        // run the block through every stage in place, first stage first
+        void processBlock(SampleType* const* channels, int numChannels, int numSamples)
+        {
+            std::apply([&](Stages&... stage) { (stage.processBlock(channels, numChannels, numSamples), ...); }, stages);
+        }
+
+        // access a stage by position
+        template <std::size_t Index>
+        auto& get() { return std::get<Index>(stages); }
+
+        template <std::size_t Index>
+        const auto& get() const { return std::get<Index>(stages); }
+
+        // access a stage by type, the type must occur once in the chain
+        template <typename Stage>
+        Stage& get() { return std::get<Stage>(stages); }
+
+        template <typename Stage>
+        const Stage& get() const { return std::get<Stage>(stages); }
+
+    private:
+        std::tuple<Stages...> stages;
+};
@@ -0,0 +1,90 @@
+# include "PerformanceTelemetry.h"
+
+void PerformanceTelemetry::prepare(double sampleRate)
+{
+    nanosecondsToLoad.store(sampleRate * 1.0e-9, std::memory_order_relaxed);
+    resetRequested.store(false, std::memory_order_relaxed);
+
+    const std::uint64_t sequenceStart = sequence.load(std::memory_order_relaxed);
+    sequence.store(sequenceStart + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    clearCounters();
+    sequence.store(sequenceStart + 2, std::memory_order_release);
+}
+
+void PerformanceTelemetry::clearCounters()
+{
+    numBlocks.store(0, std::memory_order_relaxed);
+    totalSamples.store(0, std::memory_order_relaxed);
+    totalNanoseconds.store(0, std::memory_order_relaxed);
+    numOverruns.store(0, std::memory_order_relaxed);
+    lastNanoseconds.store(0, std::memory_order_relaxed);
+    lastCycles.store(0, std::memory_order_relaxed);
+    worstNanoseconds.store(0, std::memory_order_relaxed);
+    lastLoad.store(0.0f, std::memory_order_relaxed);
+    worstLoad.store(0.0f, std::memory_order_relaxed);
+
+    for (auto& bucket : blockSizeHistogram)
+        bucket.store(0, std::memory_order_relaxed);
+    for (auto& bucket : loadHistogram)
+        bucket.store(0, std::memory_order_relaxed);
+}
+
+bool PerformanceTelemetry::readSnapshot(Snapshot& snapshot) const
+{
+    // the writer publishes once per audio block, so a handful of retries is plenty
+    constexpr int maxAttempts = 64;
+
+    for (int attempt = 0; attempt < maxAttempts; ++attempt)
+    {
+        const std::uint64_t sequenceStart = sequence.load(std::memory_order_acquire);
+        if ((sequenceStart & 1) != 0)
+            continue;
+
+        snapshot.numBlocks = numBlocks.load(std::memory_order_relaxed);
+        snapshot.numSamples = totalSamples.load(std::memory_order_relaxed);
+        snapshot.numOverruns = numOverruns.load(std::memory_order_relaxed);
+        snapshot.totalNanoseconds = totalNanoseconds.load(std::memory_order_relaxed);
+        snapshot.lastNanoseconds = lastNanoseconds.load(std::memory_order_relaxed);
+        snapshot.lastCycles = lastCycles.load(std::memory_order_relaxed);
+        snapshot.worstNanoseconds = worstNanoseconds.load(std::memory_order_relaxed);
+        snapshot.lastLoad = lastLoad.load(std::memory_order_relaxed);
+        snapshot.worstLoad = worstLoad.load(std::memory_order_relaxed);
+
+        for (std::size_t i = 0; i < blockSizeHistogram.size(); ++i)
+            snapshot.blockSizeHistogram[i] = blockSizeHistogram[i].load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < loadHistogram.size(); ++i)
+            snapshot.loadHistogram[i] = loadHistogram[i].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) != sequenceStart)
+            continue;
+
+        // derived figures are computed here so the audio thread never pays for them
+        snapshot.meanLoad = snapshot.numSamples > 0
+                          ? static_cast<float>(static_cast<double>(snapshot.totalNanoseconds) * nanosecondsToLoad.load(std::memory_order_relaxed) / static_cast<double>(snapshot.numSamples))
+                          : 0.0f;
+
+        snapshot.p99Load = 0.0f;
+        if (snapshot.numBlocks > 0)
+        {
+            // smallest bucket edge with at least 99 % of the blocks at or below it
+            const std::uint64_t threshold = snapshot.numBlocks - snapshot.numBlocks / 100;
+            std::uint64_t count = 0;
+            for (int i = 0; i < numLoadBuckets; ++i)
+            {
+                count += snapshot.loadHistogram[static_cast<std::size_t>(i)];
+                if (count >= threshold)
+                {
+                    snapshot.p99Load = i == numLoadBuckets - 1 ? snapshot.worstLoad
+                                                              : static_cast<float>(i + 1) * loadBucketWidth;
+                    break;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    return false;
+}
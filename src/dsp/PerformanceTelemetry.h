@@ -0,0 +1,188 @@
+# pragma once
+
+# include <algorithm>
+# include <array>
+# include <atomic>
+# include <bit>
+# include <chrono>
+# include <cstdint>
+
+# if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    # include <intrin.h>
+# elif defined(__x86_64__) || defined(__i386__)
+    # include <x86intrin.h>
+# endif
+
+// realtime performance counters for the audio callback.
+// the audio thread is the only writer: it times each block and updates the
+// shared counters with relaxed atomic stores inside a sequence lock. readers
+// (editor, debug tools) copy a consistent snapshot and retry when they raced
+// the writer, so the audio thread never waits, allocates or takes a lock.
+class PerformanceTelemetry
+{
+    public:
+        // block sizes 1, 2, 3-4, 5-8 ... 4097-8192, then everything larger
+        static constexpr int numBlockSizeBuckets = 15;
+
+        // block duration as a fraction of its realtime budget, in 1 % steps up
+        // to 200 %, the last bucket collects everything slower
+        static constexpr int numLoadBuckets = 201;
+        static constexpr float loadBucketWidth = 0.01f;
+
+        // consistent copy of the counters, built on the reader's side
+        struct Snapshot
+        {
+            std::uint64_t numBlocks = 0;
+            std::uint64_t numSamples = 0;
+            std::uint64_t numOverruns = 0;        // blocks that took longer than their budget
+            std::uint64_t totalNanoseconds = 0;
+            std::uint64_t lastNanoseconds = 0;
+            std::uint64_t lastCycles = 0;         // 0 where no cycle counter is available
+            std::uint64_t worstNanoseconds = 0;
+            float lastLoad = 0.0f;                // duration / budget of the last block
+            float worstLoad = 0.0f;
+            float p99Load = 0.0f;                 // upper edge of the 99th percentile bucket
+            float meanLoad = 0.0f;                // total time / total budget
+            std::array<std::uint64_t, numBlockSizeBuckets> blockSizeHistogram {};
+            std::array<std::uint64_t, numLoadBuckets> loadHistogram {};
+        };
+
+        // start time of one block
+        struct Stamp
+        {
+            std::int64_t nanoseconds;
+            std::uint64_t cycles;
+        };
+
+        // times one block from construction to destruction, covers early returns
+        class ScopedBlock
+        {
+            public:
+                ScopedBlock(PerformanceTelemetry& telemetryRef, int numSamplesInBlock)
+                    : telemetry(telemetryRef), numSamples(numSamplesInBlock), start(telemetryRef.beginBlock())
+                {
+                }
+
+                ~ScopedBlock()
+                {
+                    telemetry.endBlock(start, numSamples);
+                }
+
+                ScopedBlock(const ScopedBlock&) = delete;
+                ScopedBlock& operator=(const ScopedBlock&) = delete;
+
+            private:
+                PerformanceTelemetry& telemetry;
+                int numSamples;
+                Stamp start;
+        };
+
+        // set the sample rate the budgets are computed from and clear the counters.
+        // must not run concurrently with the audio thread (prepareToPlay)
+        void prepare(double sampleRate);
+
+        // audio thread: take the start time of a block
+        Stamp beginBlock() const
+        {
+            return Stamp { nowNanoseconds(), readCycleCounter() };
+        }
+
+        // audio thread: account one finished block
+        void endBlock(Stamp start, int numSamples)
+        {
+            const std::int64_t elapsed = std::max<std::int64_t>(0, nowNanoseconds() - start.nanoseconds);
+            const std::uint64_t cycles = readCycleCounter() - start.cycles;
+
+            const float load = numSamples > 0 ? static_cast<float>(static_cast<double>(elapsed) * nanosecondsToLoad.load(std::memory_order_relaxed) / numSamples) : 0.0f;
+            const int sizeBucket = numSamples > 1 ? std::min(numBlockSizeBuckets - 1, static_cast<int>(std::bit_width(static_cast<unsigned>(numSamples - 1))))
+                                                  : 0;
+            const int loadBucket = std::min(numLoadBuckets - 1, static_cast<int>(load * (1.0f / loadBucketWidth)));
+
+            // writer side of the sequence lock, odd while the counters are inconsistent
+            const std::uint64_t sequenceStart = sequence.load(std::memory_order_relaxed);
+            sequence.store(sequenceStart + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            // plain load first, the exchange only runs when a reset is pending
+            if (resetRequested.load(std::memory_order_relaxed) && resetRequested.exchange(false, std::memory_order_acquire))
+                clearCounters();
+
+            bump(numBlocks, 1);
+            bump(totalSamples, static_cast<std::uint64_t>(numSamples));
+            bump(totalNanoseconds, static_cast<std::uint64_t>(elapsed));
+            bump(blockSizeHistogram[static_cast<std::size_t>(sizeBucket)], 1);
+            bump(loadHistogram[static_cast<std::size_t>(loadBucket)], 1);
+            if (load > 1.0f)
+                bump(numOverruns, 1);
+
+            lastNanoseconds.store(static_cast<std::uint64_t>(elapsed), std::memory_order_relaxed);
+            lastCycles.store(cycles, std::memory_order_relaxed);
+            lastLoad.store(load, std::memory_order_relaxed);
+
+            if (static_cast<std::uint64_t>(elapsed) > worstNanoseconds.load(std::memory_order_relaxed))
+                worstNanoseconds.store(static_cast<std::uint64_t>(elapsed), std::memory_order_relaxed);
+            if (load > worstLoad.load(std::memory_order_relaxed))
+                worstLoad.store(load, std::memory_order_relaxed);
+
+            sequence.store(sequenceStart + 2, std::memory_order_release);
+        }
+
+        // any thread: copy the counters, never blocks the writer.
+        // returns false when the writer kept racing the copy (try again later)
+        bool readSnapshot(Snapshot& snapshot) const;
+
+        // any thread: ask the audio thread to clear the counters on its next block
+        void requestReset()
+        {
+            resetRequested.store(true, std::memory_order_release);
+        }
+
+    private:
+        // sample rate turned into budget: load = ns * nanosecondsToLoad / numSamples
+        std::atomic<double> nanosecondsToLoad { 44100.0 * 1.0e-9 };
+
+        std::atomic<std::uint64_t> sequence { 0 };
+        std::atomic<bool> resetRequested { false };
+
+        std::atomic<std::uint64_t> numBlocks { 0 };
+        std::atomic<std::uint64_t> totalSamples { 0 };
+        std::atomic<std::uint64_t> totalNanoseconds { 0 };
+        std::atomic<std::uint64_t> numOverruns { 0 };
+        std::atomic<std::uint64_t> lastNanoseconds { 0 };
+        std::atomic<std::uint64_t> lastCycles { 0 };
+        std::atomic<std::uint64_t> worstNanoseconds { 0 };
+        std::atomic<float> lastLoad { 0.0f };
+        std::atomic<float> worstLoad { 0.0f };
+        std::array<std::atomic<std::uint64_t>, numBlockSizeBuckets> blockSizeHistogram {};
+        std::array<std::atomic<std::uint64_t>, numLoadBuckets> loadHistogram {};
+
+        // helper for single-writer increments, no read-modify-write needed
+        static void bump(std::atomic<std::uint64_t>& counter, std::uint64_t amount)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+
+        // writer only, inside the sequence lock
+        void clearCounters();
+
+        static std::int64_t nowNanoseconds()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        static std::uint64_t readCycleCounter()
+        {
+        # if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+            return __rdtsc();
+        # elif defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+        # elif defined(__aarch64__)
+            std::uint64_t ticks;
+            asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+            return ticks;
+        # else
+            return 0;
+        # endif
+        }
+};
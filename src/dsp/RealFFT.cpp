@@ -0,0 +1,232 @@
+# include "RealFFT.h"
+
+# include <algorithm>
+# include <cmath>
+# include <utility>
+
+namespace
+{
+    // butterflies per vectorized step, stages closer together run scalar
+    constexpr int butterflyWidth = 8;
+}
+
+template <typename Sample>
+void RealFFT<Sample>::prepare(int order)
+{
+    size = 1 << order;
+    half = size / 2;
+    const double pi = 3.14159265358979323846;
+
+    bitReverse.resize(static_cast<std::size_t>(half));
+    for (int i = 0, j = 0; i < half; ++i)
+    {
+        bitReverse[static_cast<std::size_t>(i)] = j;
+        int bit = half >> 1;
+        for (; bit > 0 && (j & bit) != 0; bit >>= 1)
+            j ^= bit;
+        j |= bit;
+    }
+
+    // stage with butterflies m apart uses e^(-i pi j / m), j < m, stored at offset m - 1
+    stageReal.assign(static_cast<std::size_t>(std::max(1, half - 1)), Sample(0));
+    stageImag.assign(stageReal.size(), Sample(0));
+    for (int m = 1; m < half; m <<= 1)
+    {
+        for (int j = 0; j < m; ++j)
+        {
+            stageReal[static_cast<std::size_t>(m - 1 + j)] = static_cast<Sample>(std::cos(pi * j / m));
+            stageImag[static_cast<std::size_t>(m - 1 + j)] = static_cast<Sample>(-std::sin(pi * j / m));
+        }
+    }
+
+    splitReal.resize(static_cast<std::size_t>(half / 2 + 1));
+    splitImag.resize(splitReal.size());
+    for (int k = 0; k <= half / 2; ++k)
+    {
+        splitReal[static_cast<std::size_t>(k)] = static_cast<Sample>(std::cos(2.0 * pi * k / size));
+        splitImag[static_cast<std::size_t>(k)] = static_cast<Sample>(-std::sin(2.0 * pi * k / size));
+    }
+
+    workReal.assign(static_cast<std::size_t>(half), Sample(0));
+    workImag.assign(static_cast<std::size_t>(half), Sample(0));
+}
+
+// iterative decimation in time over input the caller stored bit-reversed
+template <typename Sample>
+void RealFFT<Sample>::transform(Sample* real, Sample* imag)
+{
+    // the first two stages together as 4-point transforms, their twiddles are 1 and -i
+    int m = 1;
+    if (half >= 4)
+    {
+        for (int start = 0; start < half; start += 4)
+        {
+            Sample* r = real + start;
+            Sample* i = imag + start;
+            const Sample r0 = r[0] + r[1], i0 = i[0] + i[1];
+            const Sample r1 = r[0] - r[1], i1 = i[0] - i[1];
+            const Sample r2 = r[2] + r[3], i2 = i[2] + i[3];
+            const Sample r3 = r[2] - r[3], i3 = i[2] - i[3];
+            r[0] = r0 + r2;
+            i[0] = i0 + i2;
+            r[2] = r0 - r2;
+            i[2] = i0 - i2;
+            r[1] = r1 + i3;
+            i[1] = i1 - r3;
+            r[3] = r1 - i3;
+            i[3] = i1 + r3;
+        }
+        m = 4;
+    }
+
+    for (; m < half; m <<= 1)
+    {
+        const Sample* wr = stageReal.data() + (m - 1);
+        const Sample* wi = stageImag.data() + (m - 1);
+
+        for (int start = 0; start < half; start += 2 * m)
+        {
+            Sample* ar = real + start;
+            Sample* ai = imag + start;
+            Sample* br = real + start + m;
+            Sample* bi = imag + start + m;
+
+            if (m < butterflyWidth)
+            {
+                for (int j = 0; j < m; ++j)
+                {
+                    const Sample tr = br[j] * wr[j] - bi[j] * wi[j];
+                    const Sample ti = br[j] * wi[j] + bi[j] * wr[j];
+                    br[j] = ar[j] - tr;
+                    bi[j] = ai[j] - ti;
+                    ar[j] += tr;
+                    ai[j] += ti;
+                }
+                continue;
+            }
+
+            // butterflyWidth at a time through local copies, which cannot
+            // alias, so the compiler vectorizes without runtime overlap checks
+            for (int j = 0; j < m; j += butterflyWidth)
+            {
+                Sample xr[butterflyWidth], xi[butterflyWidth], yr[butterflyWidth], yi[butterflyWidth];
+                for (int k = 0; k < butterflyWidth; ++k)
+                {
+                    xr[k] = ar[j + k];
+                    xi[k] = ai[j + k];
+                    yr[k] = br[j + k];
+                    yi[k] = bi[j + k];
+                }
+
+                for (int k = 0; k < butterflyWidth; ++k)
+                {
+                    const Sample tr = yr[k] * wr[j + k] - yi[k] * wi[j + k];
+                    const Sample ti = yr[k] * wi[j + k] + yi[k] * wr[j + k];
+                    yr[k] = xr[k] - tr;
+                    yi[k] = xi[k] - ti;
+                    xr[k] += tr;
+                    xi[k] += ti;
+                }
+
+                for (int k = 0; k < butterflyWidth; ++k)
+                {
+                    ar[j + k] = xr[k];
+                    ai[j + k] = xi[k];
+                    br[j + k] = yr[k];
+                    bi[j + k] = yi[k];
+                }
+            }
+        }
+    }
+}
+
+// pack even samples as real and odd samples as imaginary parts, transform at
+// half size, then split the result into the spectra of the two halves:
+// X[k] = E[k] + W^k O[k] with E, O recovered from Z[k] and conj(Z[half - k])
+template <typename Sample>
+void RealFFT<Sample>::forward(const Sample* input, Sample* real, Sample* imag)
+{
+    Sample* zr = workReal.data();
+    Sample* zi = workImag.data();
+    for (int n = 0; n < half; ++n)
+    {
+        const int slot = bitReverse[static_cast<std::size_t>(n)];
+        zr[slot] = input[2 * n];
+        zi[slot] = input[2 * n + 1];
+    }
+
+    transform(zr, zi);
+
+    real[0] = zr[0] + zi[0];
+    imag[0] = Sample(0);
+    real[half] = zr[0] - zi[0];
+    imag[half] = Sample(0);
+
+    // bins k and half - k share their inputs and twiddles, so they are done in pairs
+    for (int k = 1; k <= half / 2; ++k)
+    {
+        const int mirror = half - k;
+        const Sample er = Sample(0.5) * (zr[k] + zr[mirror]);
+        const Sample ei = Sample(0.5) * (zi[k] - zi[mirror]);
+        const Sample or_ = Sample(0.5) * (zi[k] + zi[mirror]);
+        const Sample oi = Sample(0.5) * (zr[mirror] - zr[k]);
+        const Sample wr = splitReal[static_cast<std::size_t>(k)];
+        const Sample wi = splitImag[static_cast<std::size_t>(k)];
+
+        // W^k O for bin k, and W^(half - k) = -conj(W^k) for the mirror bin
+        const Sample tr = or_ * wr - oi * wi;
+        const Sample ti = or_ * wi + oi * wr;
+        real[k] = er + tr;
+        imag[k] = ei + ti;
+        real[mirror] = er - tr;
+        imag[mirror] = ti - ei;
+    }
+}
+
+// undo the split, then an inverse half-size transform via conjugation
+template <typename Sample>
+void RealFFT<Sample>::inverse(const Sample* real, const Sample* imag, Sample* output)
+{
+    Sample* zr = workReal.data();
+    Sample* zi = workImag.data();
+
+    // Z[k] = E[k] + i O[k] with E = (X[k] + conj(X[half - k])) / 2 and
+    // O = (X[k] - conj(X[half - k])) / 2 * W^-k; stored conjugated and
+    // bit-reversed for the inverse
+    for (int k = 0; k <= half / 2; ++k)
+    {
+        const int mirror = half - k;
+        const Sample er = Sample(0.5) * (real[k] + real[mirror]);
+        const Sample ei = Sample(0.5) * (imag[k] - imag[mirror]);
+        const Sample dr = Sample(0.5) * (real[k] - real[mirror]);
+        const Sample di = Sample(0.5) * (imag[k] + imag[mirror]);
+        const Sample wr = splitReal[static_cast<std::size_t>(k)];
+        const Sample wi = -splitImag[static_cast<std::size_t>(k)];
+
+        // O[k] = D W^-k; O[half - k] = -conj(D) * -conj(W^-k) = conj(O[k])
+        const Sample or_ = dr * wr - di * wi;
+        const Sample oi = dr * wi + di * wr;
+
+        const int slot = bitReverse[static_cast<std::size_t>(k)];
+        zr[slot] = er - oi;
+        zi[slot] = -(ei + or_);
+        if (mirror != k && mirror < half)
+        {
+            const int mirrorSlot = bitReverse[static_cast<std::size_t>(mirror)];
+            zr[mirrorSlot] = er + oi;
+            zi[mirrorSlot] = ei - or_;
+        }
+    }
+
+    transform(zr, zi);
+
+    const Sample scale = Sample(1) / static_cast<Sample>(half);
+    for (int n = 0; n < half; ++n)
+    {
+        output[2 * n] = zr[n] * scale;
+        output[2 * n + 1] = -zi[n] * scale;
+    }
+}
+
+template class RealFFT<float>;
+template class RealFFT<double>;
@@ -0,0 +1,38 @@
+# pragma once
+
+# include <vector>
+
+// FFT of real signals with a power-of-two size, float and double are instantiated.
+// spectra are split into separate real and imaginary arrays of size / 2 + 1
+// bins, so loops over bins (complex multiply-accumulate in the convolver) are
+// plain arithmetic the compiler can vectorize. the real transform runs as a
+// half-size complex radix-2 FFT with per-stage contiguous twiddle tables.
+// prepare() allocates; forward() and inverse() are realtime-safe.
+template <typename Sample>
+class RealFFT
+{
+    public:
+        // allocate tables for a transform of 2^order samples, order >= 2
+        void prepare(int order);
+
+        int getSize() const { return size; }
+        int getNumBins() const { return half + 1; }
+
+        // size real samples to getNumBins() bins, unnormalised
+        void forward(const Sample* input, Sample* real, Sample* imag);
+
+        // getNumBins() bins to size real samples, scaled so inverse(forward(x)) == x
+        void inverse(const Sample* real, const Sample* imag, Sample* output);
+
+    private:
+        int size = 0;
+        int half = 0;
+
+        // half-size complex transform in place, input in bit-reversed order, output natural
+        void transform(Sample* real, Sample* imag);
+
+        std::vector<int> bitReverse;                    // half-size permutation, applied while packing
+        std::vector<Sample> stageReal, stageImag;       // e^(-i pi j / m) for every stage half-length m, concatenated
+        std::vector<Sample> splitReal, splitImag;       // e^(-2 i pi k / size), k <= half / 2, to split the packed spectrum
+        std::vector<Sample> workReal, workImag;         // half-size scratch
+};
@@ -0,0 +1,112 @@
+# include "RealtimeCheck.h"
+
+# include <atomic>
+
+# if defined(__GLIBC__)
+    # include <execinfo.h>
+    # include <unistd.h>
+    # define ODPEDAL_HAS_BACKTRACE 1
+# endif
+
+namespace
+{
+    // violations kept with their call stacks, later ones are only counted
+    constexpr int maxRecorded = 32;
+    constexpr int maxFrames = 48;
+
+    struct Violation
+    {
+        const char* operation;
+        const char* scope;
+        void* frames[maxFrames];
+        int numFrames;
+    };
+
+    Violation violations[maxRecorded];
+    std::atomic<int> violationCount { 0 };
+
+    // per thread: scope nesting, the outermost scope's name, and a guard so
+    // allocations made while taking a call stack are not reported again
+    thread_local int scopeDepth = 0;
+    thread_local const char* outerScope = nullptr;
+    thread_local bool reporting = false;
+}
+
+RealtimeCheck::Scope::Scope(const char* name)
+{
+    if (scopeDepth++ == 0)
+        outerScope = name;
+}
+
+RealtimeCheck::Scope::~Scope()
+{
+    if (--scopeDepth == 0)
+        outerScope = nullptr;
+}
+
+bool RealtimeCheck::isActive()
+{
+    return scopeDepth > 0 && !reporting;
+}
+
+void RealtimeCheck::reportViolation(const char* operation)
+{
+    if (reporting)
+        return;
+
+    reporting = true;
+
+    const int index = violationCount.fetch_add(1, std::memory_order_relaxed);
+    if (index < maxRecorded)
+    {
+        Violation& violation = violations[index];
+        violation.operation = operation;
+        violation.scope = outerScope;
+        violation.numFrames = 0;
+    # if defined(ODPEDAL_HAS_BACKTRACE)
+        violation.numFrames = backtrace(violation.frames, maxFrames);
+    # endif
+    }
+
+    reporting = false;
+}
+
+int RealtimeCheck::getViolationCount()
+{
+    return violationCount.load(std::memory_order_relaxed);
+}
+
+void RealtimeCheck::printViolations(std::FILE* file)
+{
+    const int count = getViolationCount();
+    const int recorded = count < maxRecorded ? count : maxRecorded;
+
+    for (int i = 0; i < recorded; ++i)
+    {
+        const Violation& violation = violations[i];
+        std::fprintf(file, "realtime violation %d: %s inside %s\n", i + 1, violation.operation,
+                     violation.scope != nullptr ? violation.scope : "(unnamed scope)");
+
+    # if defined(ODPEDAL_HAS_BACKTRACE)
+        // straight to the descriptor, backtrace_symbols() would allocate
+        std::fflush(file);
+        backtrace_symbols_fd(violation.frames, violation.numFrames, fileno(file));
+    # endif
+    }
+
+    if (count > recorded)
+        std::fprintf(file, "... and %d more without call stacks\n", count - recorded);
+}
+
+void RealtimeCheck::clearViolations()
+{
+    violationCount.store(0, std::memory_order_relaxed);
+}
+
+void RealtimeCheck::prepare()
+{
+# if defined(ODPEDAL_HAS_BACKTRACE)
+    void* frames[4];
+    backtrace(frames, 4);
+# endif
+}
@@ -0,0 +1,57 @@
+# pragma once
+
+# include <cstdio>
+
+// realtime-safety checking for headless tests. code that must not allocate,
+// free or block marks itself with ODPEDAL_REALTIME_SCOPE(name); a process that
+// links the hooks in tools/od_rtcheck (replacements for malloc and friends and
+// the blocking pthread calls) reports every such call made on a thread while
+// it is inside a scope, together with its call stack. violations are recorded
+// into preallocated slots without allocating and printed later from a normal
+// thread. new and delete are caught through the malloc and free they call.
+//
+// the macro is empty unless the build defines ODPEDAL_ENABLE_RTCHECK (CMake
+// option ODPEDAL_RTCHECK); test code can also open a RealtimeCheck::Scope
+// directly. call stacks need glibc, elsewhere only the counts are kept.
+namespace RealtimeCheck
+{
+    // marks the calling thread as realtime for its lifetime, scopes nest and
+    // reports name the outermost one; name must outlive it (a string literal)
+    class Scope
+    {
+        public:
+            explicit Scope(const char* name);
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+    };
+
+    // true on a thread inside a scope, except while it records a violation
+    bool isActive();
+
+    // record a violation on the calling thread, called by the hooks
+    void reportViolation(const char* operation);
+
+    // violations since the last clear, including those beyond the recorded slots
+    int getViolationCount();
+
+    // print the recorded violations with their call stacks
+    void printViolations(std::FILE* file);
+
+    // forget every violation, only while no thread is inside a scope
+    void clearViolations();
+
+    // load the stack unwinder up front, so the first report does not allocate
+    // on the checked thread just to take its own call stack
+    void prepare();
+}
+
+# define ODPEDAL_REALTIME_CONCAT_INNER(a, b) a##b
+# define ODPEDAL_REALTIME_CONCAT(a, b) ODPEDAL_REALTIME_CONCAT_INNER(a, b)
+
+# if defined(ODPEDAL_ENABLE_RTCHECK) && ODPEDAL_ENABLE_RTCHECK
+    # define ODPEDAL_REALTIME_SCOPE(name) RealtimeCheck::Scope ODPEDAL_REALTIME_CONCAT(realtimeScope, __LINE__)(name)
+# else
+    # define ODPEDAL_REALTIME_SCOPE(name) ((void) 0)
+# endif
@@ -0,0 +1,125 @@
+# include "Saturators.h"
+
+# include <array>
+
+namespace Saturators
+{
+    namespace
+    {
+        std::array<float, lookupSize + 2> lookupTable {};
+
+        // fills the table, run exactly once through the static in prepareLookupTable()
+        bool fillLookupTable()
+        {
+            for (int i = 0; i <= lookupSize; ++i)
+            {
+                double x = -lookupRange + static_cast<double>(i) / lookupScale;
+                lookupTable[i] = static_cast<float>(std::tanh(x));
+            }
+
+            // guard point so an input of exactly +lookupRange can interpolate
+            lookupTable[lookupSize + 1] = lookupTable[lookupSize];
+            return true;
+        }
+    }
+
+    namespace
+    {
+        // Li2(u) for u in [-1, 0] from its expansion in w = -log(1 - u):
+        // Li2 = w - w^2/4 + sum of B2k w^(2k+1) / (2k+1)!, Bn the Bernoulli numbers.
+        // |w| <= log(2) here, so nine terms reach double precision
+        double dilogarithmNegative(double u)
+        {
+            const double w = -std::log1p(-u);
+            const double w2 = w * w;
+            double p = 4.518980029619918e-16;
+            p = p * w2 - 1.9939295860721074e-14;
+            p = p * w2 + 8.921691020456452e-13;
+            p = p * w2 - 4.0647616451442256e-11;
+            p = p * w2 + 1.8978869988971e-09;
+            p = p * w2 - 9.185773074661964e-08;
+            p = p * w2 + 4.72411186696901e-06;
+            p = p * w2 - 2.777777777777778e-04;
+            p = p * w2 + 2.777777777777778e-02;
+            return w - 0.25 * w2 + w * w2 * p;
+        }
+    }
+
+    double tanhAntiderivative2(double input)
+    {
+        // log(cosh(t)) = t - log(2) + log(1 + e^-2t) for t >= 0, and
+        // d/dt Li2(-e^-2t) = 2 log(1 + e^-2t), so the integral is closed form;
+        // log(cosh) is even, so its integral from 0 is odd
+        const double x = std::abs(input);
+        const double pi2Over12 = 0.82246703342411321824;   // -Li2(-1)
+        const double value = 0.5 * x * x - 0.69314718055994530942 * x
+                           + 0.5 * (dilogarithmNegative(-std::exp(-2.0 * x)) + pi2Over12);
+        return input < 0.0 ? -value : value;
+    }
+
+    void prepareLookupTable()
+    {
+        // thread-safe one-time initialisation, several instances may prepare concurrently
+        static const bool ready = fillLookupTable();
+        (void) ready;
+    }
+
+    const float* getLookupTable()
+    {
+        return lookupTable.data();
+    }
+
+    template <typename Sample>
+    void processBlockExact(Sample* buffer, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            buffer[i] = tanhExact(buffer[i]);
+    }
+
+    template <typename Sample>
+    void processBlockPade(Sample* buffer, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            buffer[i] = tanhPade(buffer[i]);
+    }
+
+    template <typename Sample>
+    void processBlockPolynomial(Sample* buffer, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            buffer[i] = tanhPolynomial(buffer[i]);
+    }
+
+    template <typename Sample>
+    void processBlockLookup(Sample* buffer, int numSamples)
+    {
+        const float* table = lookupTable.data();
+        for (int i = 0; i < numSamples; ++i)
+            buffer[i] = tanhLookup(table, buffer[i]);
+    }
+
+    template <typename Sample>
+    void processBlock(SaturatorType type, Sample* buffer, int numSamples)
+    {
+        switch (type)
+        {
+            case SaturatorType::Exact:      processBlockExact(buffer, numSamples); break;
+            case SaturatorType::Pade:       processBlockPade(buffer, numSamples); break;
+            case SaturatorType::Polynomial: processBlockPolynomial(buffer, numSamples); break;
+            case SaturatorType::Lookup:     processBlockLookup(buffer, numSamples); break;
+            case SaturatorType::Adaa1:
+            case SaturatorType::Adaa2:      processBlockExact(buffer, numSamples); break;
+        }
+    }
+
+    template void processBlockExact<float>(float*, int);
+    template void processBlockExact<double>(double*, int);
+    template void processBlockPade<float>(float*, int);
+    template void processBlockPade<double>(double*, int);
+    template void processBlockPolynomial<float>(float*, int);
+    template void processBlockPolynomial<double>(double*, int);
+    template void processBlockLookup<float>(float*, int);
+    template void processBlockLookup<double>(double*, int);
+    template void processBlock<float>(SaturatorType, float*, int);
+    template void processBlock<double>(SaturatorType, double*, int);
+}
@@ -0,0 +1,149 @@
+# pragma once
+
+# include <cmath>
+# include <algorithm>
+# include <bit>
+
+// tanh-shaped soft clipping kernels with selectable accuracy.
+// every kernel has a scalar form (one sample) and a block form (whole buffer);
+// the block forms are plain loops over the buffer written to auto-vectorize.
+// the ADAA modes keep per-channel state, OverdriveDSP runs them through
+// TanhAdaa; the stateless kernels here treat them as Exact.
+enum class SaturatorType
+{
+    Exact,       // std::tanh, reference
+    Pade,        // [7/6] Pade rational, max abs error 1.0e-4 vs std::tanh
+    Polynomial,  // clamped odd degree-13 polynomial, max abs error 1.8e-3 vs std::tanh
+    Lookup,      // linearly interpolated table on [-8, 8], max abs error 2.4e-5 vs std::tanh
+    Adaa1,       // std::tanh with first-order antiderivative antialiasing, half a sample of delay
+    Adaa2        // std::tanh with second-order antiderivative antialiasing, one sample of delay
+};
+
+namespace Saturators
+{
+    // documented max abs error against std::tanh over the whole float range.
+    // the ADAA modes band-limit std::tanh rather than approximate it, so they
+    // have no pointwise bound and report 0 like Exact
+    constexpr float maxAbsError(SaturatorType type)
+    {
+        switch (type)
+        {
+            case SaturatorType::Exact:      return 0.0f;
+            case SaturatorType::Pade:       return 1.0e-4f;
+            case SaturatorType::Polynomial: return 1.8e-3f;
+            case SaturatorType::Lookup:     return 2.4e-5f;
+            case SaturatorType::Adaa1:      return 0.0f;
+            case SaturatorType::Adaa2:      return 0.0f;
+        }
+        return 0.0f;
+    }
+
+    // lookup table layout
+    constexpr int lookupSize = 1024;            // intervals across the table range
+    constexpr float lookupRange = 8.0f;         // table covers [-lookupRange, lookupRange]
+    constexpr float lookupScale = lookupSize / (2.0f * lookupRange);
+
+    // fills the lookup table, call from prepare() so the audio thread never does it
+    void prepareLookupTable();
+
+    // table of lookupSize + 2 points (one guard point for interpolation at the top edge)
+    const float* getLookupTable();
+
+    // scalar kernels, float or double. the constants are the float fits, so
+    // the double forms carry the same documented error
+    template <typename Sample>
+    inline Sample tanhExact(Sample input)
+    {
+        return std::tanh(input);
+    }
+
+    template <typename Sample>
+    inline Sample tanhPade(Sample input)
+    {
+        // the [7/6] approximant crosses 1 just below |x| = 5
+        Sample x = std::clamp(input, Sample(-5), Sample(5));
+        Sample x2 = x * x;
+        Sample numerator = x * (Sample(135135) + x2 * (Sample(17325) + x2 * (Sample(378) + x2)));
+        Sample denominator = Sample(135135) + x2 * (Sample(62370) + x2 * (Sample(3150) + x2 * Sample(28)));
+        return std::clamp(numerator / denominator, Sample(-1), Sample(1));
+    }
+
+    template <typename Sample>
+    inline Sample tanhPolynomial(Sample input)
+    {
+        // odd minimax-style fit of tanh on [-3.2, 3.2] with unity slope at zero
+        Sample x = std::clamp(input, Sample(-3.2f), Sample(3.2f));
+        Sample x2 = x * x;
+        Sample p = Sample(4.057304928e-6f);
+        p = p * x2 - Sample(1.535205563e-4f);
+        p = p * x2 + Sample(2.366804795e-3f);
+        p = p * x2 - Sample(1.943240501e-2f);
+        p = p * x2 + Sample(9.534773682e-2f);
+        p = p * x2 - Sample(3.160843556e-1f);
+        return std::clamp(x + x * x2 * p, Sample(-1), Sample(1));
+    }
+
+    template <typename Sample>
+    inline Sample tanhLookup(const float* table, Sample input)
+    {
+        const Sample range = Sample(lookupRange);
+        Sample position = (std::clamp(input, -range, range) + range) * Sample(lookupScale);
+        int index = static_cast<int>(position);
+        Sample fraction = position - static_cast<Sample>(index);
+        return Sample(table[index]) + fraction * (Sample(table[index + 1]) - Sample(table[index]));
+    }
+
+    // std::tanh to within a few float ulp in plain arithmetic with no libm call,
+    // so loops over it vectorize (OverdriveBank's Exact mode). below 0.625 an
+    // odd polynomial, above it 1 - 2 / (e^2x + 1) with e^2x = 2^n e^r, |r| <= log(2) / 2
+    constexpr float tanhAccurateMaxAbsError = 1.2e-7f;   // two float ulp just below 1
+
+    inline float tanhAccurate(float input)
+    {
+        const float x = std::min(std::abs(input), 9.0f);   // tanh(9) rounds to 1
+        const float x2 = x * x;
+        float p = -5.70498872745e-3f;
+        p = p * x2 + 2.06390887954e-2f;
+        p = p * x2 - 5.37397155531e-2f;
+        p = p * x2 + 1.33314422036e-1f;
+        p = p * x2 - 3.33332819422e-1f;
+        const float small = x + x * x2 * p;
+
+        const float y = x + x;
+        const int n = static_cast<int>(y * 1.44269504089f + 0.5f);   // round, y >= 0
+        const float fn = static_cast<float>(n);
+        const float r = y - fn * 0.693359375f + fn * 2.12194440e-4f;
+        float e = 1.9875691500e-4f;
+        e = e * r + 1.3981999507e-3f;
+        e = e * r + 8.3334519073e-3f;
+        e = e * r + 4.1665795894e-2f;
+        e = e * r + 1.6666665459e-1f;
+        e = e * r + 5.0000001201e-1f;
+        e = e * r * r + r + 1.0f;
+        const float large = 1.0f - 2.0f / (e * std::bit_cast<float>((n + 127) << 23) + 1.0f);
+
+        return std::copysign(x < 0.625f ? small : large, input);
+    }
+
+    // antiderivatives of tanh for the ADAA modes, in double because ADAA
+    // divides their differences by small input steps.
+    // first: log(cosh(x)), written so it cannot overflow
+    inline double tanhAntiderivative1(double input)
+    {
+        const double x = std::abs(input);
+        return x + std::log1p(std::exp(-2.0 * x)) - 0.69314718055994530942;
+    }
+
+    // second: the integral of log(cosh(t)) from 0 to x, via the dilogarithm
+    double tanhAntiderivative2(double input);
+
+    // block kernels, instantiated for float and double
+    template <typename Sample> void processBlockExact(Sample* buffer, int numSamples);
+    template <typename Sample> void processBlockPade(Sample* buffer, int numSamples);
+    template <typename Sample> void processBlockPolynomial(Sample* buffer, int numSamples);
+    template <typename Sample> void processBlockLookup(Sample* buffer, int numSamples);
+
+    // dispatch a whole block to the selected kernel
+    template <typename Sample>
+    void processBlock(SaturatorType type, Sample* buffer, int numSamples);
+}
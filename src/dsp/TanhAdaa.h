@@ -0,0 +1,116 @@
+# pragma once
+
+# include <cmath>
+
+# include "Saturators.h"
+
+// tanh clipper with antiderivative antialiasing (ADAA) for NumLanes channels
+// interleaved frame by frame, like BiquadCascade. instead of tanh(x[n]) each
+// output is the mean of tanh over the straight line between consecutive inputs,
+// taken from closed-form antiderivatives; that suppresses most of the aliasing
+// the plain clipper folds back at 1x. first order averages over one input step
+// (half a sample of delay), second order over two (one sample of delay).
+// the divided differences subtract nearly equal values and divide by the input
+// step, so state and arithmetic are double for both sample types, and steps
+// below a tolerance fall back to the limit the difference tends to.
+template <int NumLanes = 1>
+class TanhAdaa
+{
+    public:
+        static_assert(NumLanes > 0, "TanhAdaa needs at least one lane");
+
+        // clear the history, the next call starts from a silent input
+        void reset()
+        {
+            for (Lane& lane : lanes)
+                lane = Lane();
+        }
+
+        // y[n] = (F1(x[n]) - F1(x[n-1])) / (x[n] - x[n-1]), F1 = log(cosh)
+        template <typename Sample>
+        void processFirstOrder(Sample* frames, int numFrames)
+        {
+            for (int i = 0; i < numFrames; ++i)
+            {
+                for (int l = 0; l < NumLanes; ++l)
+                {
+                    Lane& lane = lanes[l];
+                    const double x = static_cast<double>(frames[i * NumLanes + l]);
+                    const double f1 = Saturators::tanhAntiderivative1(x);
+                    const double step = x - lane.x1;
+
+                    double y;
+                    if (std::abs(step) < firstOrderTolerance)
+                        y = std::tanh(0.5 * (x + lane.x1));
+                    else
+                        y = (f1 - lane.f1x1) / step;
+
+                    lane.x1 = x;
+                    lane.f1x1 = f1;
+                    frames[i * NumLanes + l] = static_cast<Sample>(y);
+                }
+            }
+        }
+
+        // y[n] = 2 / (x[n] - x[n-2]) * (D(x[n], x[n-1]) - D(x[n-1], x[n-2])),
+        // D(a, b) = (F2(a) - F2(b)) / (a - b), F2 the antiderivative of log(cosh)
+        template <typename Sample>
+        void processSecondOrder(Sample* frames, int numFrames)
+        {
+            for (int i = 0; i < numFrames; ++i)
+            {
+                for (int l = 0; l < NumLanes; ++l)
+                {
+                    Lane& lane = lanes[l];
+                    const double x = static_cast<double>(frames[i * NumLanes + l]);
+                    const double f2 = Saturators::tanhAntiderivative2(x);
+                    const double step = x - lane.x1;
+
+                    const double d = std::abs(step) < secondOrderTolerance
+                                   ? Saturators::tanhAntiderivative1(0.5 * (x + lane.x1))
+                                   : (f2 - lane.f2x1) / step;
+
+                    double y;
+                    const double span = x - lane.x2;
+                    if (std::abs(span) >= secondOrderTolerance)
+                    {
+                        y = 2.0 * (d - lane.d1) / span;
+                    }
+                    else
+                    {
+                        // x[n] ~ x[n-2]: expand around their midpoint instead
+                        const double mid = 0.5 * (x + lane.x2);
+                        const double delta = mid - lane.x1;
+                        if (std::abs(delta) < secondOrderTolerance)
+                            y = std::tanh(0.5 * (mid + lane.x1));
+                        else
+                            y = 2.0 / delta * (Saturators::tanhAntiderivative1(mid)
+                                             + (lane.f2x1 - Saturators::tanhAntiderivative2(mid)) / delta);
+                    }
+
+                    lane.x2 = lane.x1;
+                    lane.x1 = x;
+                    lane.f2x1 = f2;
+                    lane.d1 = d;
+                    frames[i * NumLanes + l] = static_cast<Sample>(y);
+                }
+            }
+        }
+
+    private:
+        // input steps below these use the ill-conditioned fallbacks; the second
+        // order divides twice, so it needs the larger step to stay accurate
+        static constexpr double firstOrderTolerance = 1.0e-6;
+        static constexpr double secondOrderTolerance = 1.0e-4;
+
+        // history of one channel, all zero for a silent past (F1(0) = F2(0) = 0)
+        struct Lane
+        {
+            double x1 = 0.0, x2 = 0.0;   // previous two inputs
+            double f1x1 = 0.0;           // F1(x1)
+            double f2x1 = 0.0;           // F2(x1)
+            double d1 = 0.0;             // D(x1, x2)
+        };
+
+        Lane lanes[NumLanes];
+};
@@ -0,0 +1,149 @@
+# include "TraceRecorder.h"
+
+# include <algorithm>
+
+namespace
+{
+    // how often the writer drains the rings
+    constexpr auto drainInterval = std::chrono::milliseconds(50);
+
+    // the calling thread's claimed ring and its trace thread id
+    thread_local int threadRingIndex = -1;
+}
+
+TraceRecorder& TraceRecorder::getInstance()
+{
+    static TraceRecorder instance;
+    return instance;
+}
+
+TraceRecorder::~TraceRecorder()
+{
+    stop();
+}
+
+std::int64_t TraceRecorder::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool TraceRecorder::start(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(controlMutex);
+    if (recording.load(std::memory_order_relaxed))
+        return false;
+
+    file = std::fopen(path.c_str(), "w");
+    if (file == nullptr)
+        return false;
+
+    if (rings == nullptr)
+    {
+        rings = std::make_unique<Ring[]>(maxThreads);
+        for (int i = 0; i < maxThreads; ++i)
+            rings[i].events.resize(eventsPerThread);
+    }
+
+    // leftovers from threads that were mid-event when the last recording stopped
+    for (int i = 0; i < maxThreads; ++i)
+        rings[i].tail.store(rings[i].head.load(std::memory_order_acquire), std::memory_order_relaxed);
+
+    std::fputs("[\n", file);
+    firstEvent = true;
+    droppedEvents.store(0, std::memory_order_relaxed);
+    startTime.store(now(), std::memory_order_relaxed);
+
+    writerRunning.store(true, std::memory_order_relaxed);
+    writer = std::thread([this] { writerLoop(); });
+
+    // publishes the rings to the recording threads
+    recording.store(true, std::memory_order_release);
+    return true;
+}
+
+void TraceRecorder::stop()
+{
+    std::lock_guard<std::mutex> lock(controlMutex);
+    if (!recording.load(std::memory_order_relaxed))
+        return;
+
+    recording.store(false, std::memory_order_release);
+    writerRunning.store(false, std::memory_order_relaxed);
+    writer.join();
+
+    drain();
+    std::fputs("\n]\n", file);
+    std::fclose(file);
+    file = nullptr;
+}
+
+TraceRecorder::Ring* TraceRecorder::getThreadRing()
+{
+    if (threadRingIndex == -1)
+    {
+        int index = claimedRings.fetch_add(1, std::memory_order_relaxed);
+        threadRingIndex = index < maxThreads ? index : maxThreads;
+    }
+
+    return threadRingIndex < maxThreads ? &rings[threadRingIndex] : nullptr;
+}
+
+void TraceRecorder::record(const char* name, char phase)
+{
+    if (!recording.load(std::memory_order_acquire))
+        return;
+
+    Ring* ring = getThreadRing();
+    if (ring == nullptr)
+    {
+        droppedEvents.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // a full ring drops instead of waiting for the writer
+    const std::uint64_t head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) >= eventsPerThread)
+    {
+        droppedEvents.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    ring->events[head & (eventsPerThread - 1)] = Event { name, now() - startTime.load(std::memory_order_relaxed), phase };
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+void TraceRecorder::writerLoop()
+{
+    while (writerRunning.load(std::memory_order_relaxed))
+    {
+        std::this_thread::sleep_for(drainInterval);
+        drain();
+    }
+}
+
+// append every queued event to the file, trace thread ids are ring index + 1
+void TraceRecorder::drain()
+{
+    const int numRings = std::min(claimedRings.load(std::memory_order_acquire), maxThreads);
+
+    for (int i = 0; i < numRings; ++i)
+    {
+        Ring& ring = rings[i];
+        const std::uint64_t head = ring.head.load(std::memory_order_acquire);
+        std::uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+
+        for (; tail != head; ++tail)
+        {
+            const Event& event = ring.events[tail & (eventsPerThread - 1)];
+            std::fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%d}",
+                         firstEvent ? "" : ",\n", event.name, event.phase,
+                         static_cast<double>(event.nanoseconds) * 1.0e-3, i + 1);
+            firstEvent = false;
+        }
+
+        ring.tail.store(tail, std::memory_order_release);
+    }
+
+    std::fflush(file);
+}
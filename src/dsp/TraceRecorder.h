@@ -0,0 +1,122 @@
+# pragma once
+
+# include <atomic>
+# include <chrono>
+# include <cstdint>
+# include <cstdio>
+# include <memory>
+# include <mutex>
+# include <string>
+# include <thread>
+# include <vector>
+
+// timeline recorder for profiling, written as Chrome trace-event JSON that
+// Perfetto (ui.perfetto.dev) and chrome://tracing open directly.
+// each recording thread claims one preallocated single-producer ring on its
+// first event and pushes begin/end events into it without locks or
+// allocation; a full ring drops events and counts them. a background writer
+// drains every ring a few times a second and appends them to the file.
+//
+// instrumented code uses ODPEDAL_TRACE_SCOPE(name) with a string literal. the
+// macro is empty unless the build defines ODPEDAL_ENABLE_TRACING (CMake option
+// ODPEDAL_TRACING), so release builds carry no tracing code at all.
+class TraceRecorder
+{
+    public:
+        // threads that can record at once, and events each can hold between drains
+        static constexpr int maxThreads = 16;
+        static constexpr std::uint32_t eventsPerThread = 1u << 15;
+
+        // the process-wide recorder
+        static TraceRecorder& getInstance();
+
+        ~TraceRecorder();
+
+        // open the output file and start the writer thread, false if the file
+        // cannot be created or a recording is already running
+        bool start(const std::string& path);
+
+        // stop recording, flush what is left and close the file
+        void stop();
+
+        bool isRecording() const { return recording.load(std::memory_order_acquire); }
+
+        // events lost to full rings or to more than maxThreads threads
+        std::uint64_t getDroppedEvents() const { return droppedEvents.load(std::memory_order_relaxed); }
+
+        // record one begin ('B') or end ('E') event on the calling thread.
+        // name must outlive the recording, in practice a string literal
+        void record(const char* name, char phase);
+
+        // begin event on construction, end event on destruction
+        class Scope
+        {
+            public:
+                explicit Scope(const char* scopeName) : name(scopeName)
+                {
+                    getInstance().record(name, 'B');
+                }
+
+                ~Scope()
+                {
+                    getInstance().record(name, 'E');
+                }
+
+                Scope(const Scope&) = delete;
+                Scope& operator=(const Scope&) = delete;
+
+            private:
+                const char* name;
+        };
+
+    private:
+        TraceRecorder() = default;
+
+        struct Event
+        {
+            const char* name;
+            std::int64_t nanoseconds;   // since the recording started
+            char phase;
+        };
+
+        // single producer (the owning thread), single consumer (the writer)
+        struct Ring
+        {
+            std::vector<Event> events;
+            alignas(64) std::atomic<std::uint64_t> head { 0 };
+            alignas(64) std::atomic<std::uint64_t> tail { 0 };
+        };
+
+        std::atomic<bool> recording { false };
+        std::atomic<bool> writerRunning { false };
+        std::atomic<int> claimedRings { 0 };
+        std::atomic<std::uint64_t> droppedEvents { 0 };
+        std::atomic<std::int64_t> startTime { 0 };
+
+        // allocated by the first start() and kept until exit, so a thread's
+        // claim stays valid across recordings
+        std::unique_ptr<Ring[]> rings;
+
+        std::mutex controlMutex;    // start() and stop() only, never the recording threads
+        std::FILE* file = nullptr;
+        bool firstEvent = true;
+        std::thread writer;
+
+        // ring of the calling thread, claimed on first use, nullptr when none is left
+        Ring* getThreadRing();
+
+        // writer thread body and the drain it repeats
+        void writerLoop();
+        void drain();
+
+        static std::int64_t now();
+};
+
+# define ODPEDAL_TRACE_CONCAT_INNER(a, b) a##b
+# define ODPEDAL_TRACE_CONCAT(a, b) ODPEDAL_TRACE_CONCAT_INNER(a, b)
+
+# if defined(ODPEDAL_ENABLE_TRACING) && ODPEDAL_ENABLE_TRACING
+    # define ODPEDAL_TRACE_SCOPE(name) TraceRecorder::Scope ODPEDAL_TRACE_CONCAT(traceScope, __LINE__)(name)
+# else
+    # define ODPEDAL_TRACE_SCOPE(name) ((void) 0)
+# endif
@@ -1,6 +1,7 @@
 # pragma once
 
 # include <juce_gui_basics/juce_gui_basics.h>
+# include "PedalImageCache.h"
 
 class GoldKnobLookAndFeel : public juce::LookAndFeel_V4
 {
@@ -10,9 +11,8 @@ class GoldKnobLookAndFeel : public juce::LookAndFeel_V4
                             juce::Slider&) override;
 
     private:
-        juce::Image knobImage;
-        bool knobImageLoaded = false;
-        void loadKnobImage();
+        // pre-rendered knob filmstrips, shared with every other editor
+        juce::SharedResourcePointer<PedalImageCache> imageCache;
     };
 
 class GoldButtonLookAndFeel : public juce::LookAndFeel_V4
@@ -21,7 +21,6 @@ class GoldButtonLookAndFeel : public juce::LookAndFeel_V4
         void drawToggleButton(juce::Graphics& g, juce::ToggleButton& button, bool shouldDrawButtonAsHighlighted, bool shouldDrawButtonAsDown) override;
 
     private:
-        juce::Image bypassUpImage;
-        bool bypassImagesLoaded = false;
-        void loadBypassImages();
+        // baked footswitch artwork, shared with every other editor
+        juce::SharedResourcePointer<PedalImageCache> imageCache;
 };
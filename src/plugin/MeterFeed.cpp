@@ -0,0 +1,112 @@
+# include "MeterFeed.h"
+
+# include <algorithm>
+# include <cmath>
+
+MeterFeed::MeterFeed()
+    : sampleSlots(static_cast<size_t>(SAMPLE_CAPACITY), 0.0f)
+{
+}
+
+template <typename Sample>
+void MeterFeed::measure(const Sample* const* channels, int numChannels, int numSamples, float& peak, float& rms)
+{
+    peak = 0.0f;
+    rms = 0.0f;
+    if (numChannels <= 0 || numSamples <= 0)
+        return;
+
+    // element-wise partial sums and maxima, so the loop vectorizes without fast-math
+    constexpr int width = 8;
+    Sample partialPeak[width] = {};
+    Sample partialSquares[width] = {};
+    Sample peakSoFar = 0;
+    Sample sumOfSquares = 0;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const Sample* samples = channels[channel];
+        int i = 0;
+
+        for (; i + width <= numSamples; i += width)
+        {
+            for (int j = 0; j < width; ++j)
+            {
+                partialPeak[j] = std::max(partialPeak[j], std::abs(samples[i + j]));
+                partialSquares[j] += samples[i + j] * samples[i + j];
+            }
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            peakSoFar = std::max(peakSoFar, std::abs(samples[i]));
+            sumOfSquares += samples[i] * samples[i];
+        }
+    }
+
+    for (int j = 0; j < width; ++j)
+    {
+        peakSoFar = std::max(peakSoFar, partialPeak[j]);
+        sumOfSquares += partialSquares[j];
+    }
+
+    peak = static_cast<float>(peakSoFar);
+    rms = static_cast<float>(std::sqrt(sumOfSquares / static_cast<Sample>(numChannels * numSamples)));
+}
+
+template void MeterFeed::measure<float>(const float* const*, int, int, float&, float&);
+template void MeterFeed::measure<double>(const double* const*, int, int, float&, float&);
+
+template <typename Sample>
+void MeterFeed::push(const Levels& levels, const Sample* samples, int numSamples)
+{
+    int start1, size1, start2, size2;
+
+    // a full queue means the editor is closed or stalled, drop rather than wait
+    levelFifo.prepareToWrite(1, start1, size1, start2, size2);
+    if (size1 > 0)
+    {
+        levelSlots[static_cast<size_t>(start1)] = levels;
+        levelFifo.finishedWrite(1);
+    }
+
+    sampleFifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+    std::copy(samples, samples + size1, sampleSlots.begin() + start1);
+    std::copy(samples + size1, samples + size1 + size2, sampleSlots.begin() + start2);
+    sampleFifo.finishedWrite(size1 + size2);
+}
+
+template void MeterFeed::push<float>(const Levels&, const float*, int);
+template void MeterFeed::push<double>(const Levels&, const double*, int);
+
+void MeterFeed::attach()
+{
+    // the read side belongs to the editor, so the stale data is skipped from here
+    levelFifo.finishedRead(levelFifo.getNumReady());
+    sampleFifo.finishedRead(sampleFifo.getNumReady());
+    attached.store(true, std::memory_order_release);
+}
+
+bool MeterFeed::popLevels(Levels& levels)
+{
+    int start1, size1, start2, size2;
+    levelFifo.prepareToRead(1, start1, size1, start2, size2);
+    if (size1 == 0)
+        return false;
+
+    levels = levelSlots[static_cast<size_t>(start1)];
+    levelFifo.finishedRead(1);
+    return true;
+}
+
+int MeterFeed::popSamples(float* destination, int maxSamples)
+{
+    int start1, size1, start2, size2;
+    sampleFifo.prepareToRead(maxSamples, start1, size1, start2, size2);
+
+    std::copy(sampleSlots.begin() + start1, sampleSlots.begin() + start1 + size1, destination);
+    std::copy(sampleSlots.begin() + start2, sampleSlots.begin() + start2 + size2, destination + size1);
+    sampleFifo.finishedRead(size1 + size2);
+
+    return size1 + size2;
+}
@@ -0,0 +1,68 @@
+# pragma once
+
+# include <array>
+# include <atomic>
+# include <vector>
+# include <juce_core/juce_core.h>
+
+// hands level readings and output samples from the audio thread to the editor.
+// both queues are preallocated single-producer/single-consumer FIFOs: the audio
+// thread drops data when a queue is full instead of waiting, and the editor
+// drains them from its timer. nothing is queued while no editor is attached.
+class MeterFeed
+{
+    public:
+        // one reading per processed block, linear gain
+        struct Levels
+        {
+            float inputPeak = 0.0f;
+            float inputRms = 0.0f;
+            float outputPeak = 0.0f;
+            float outputRms = 0.0f;
+            float clipperPeak = 0.0f;   // drive into the tanh stage
+        };
+
+        // blocks and samples the editor may fall behind by before data is dropped
+        static constexpr int LEVEL_CAPACITY = 128;
+        static constexpr int SAMPLE_CAPACITY = 1 << 15;
+
+        // constructor, allocates the sample queue
+        MeterFeed();
+
+        // sample rate of the pushed audio, for the spectrum's frequency axis
+        void setSampleRate(double newSampleRate) { sampleRate.store(newSampleRate, std::memory_order_relaxed); }
+        double getSampleRate() const { return sampleRate.load(std::memory_order_relaxed); }
+
+        // audio thread: peak and RMS over every channel of a block, float or double
+        template <typename Sample>
+        static void measure(const Sample* const* channels, int numChannels, int numSamples, float& peak, float& rms);
+
+        // audio thread: queue one block's levels and its output samples for the spectrum
+        template <typename Sample>
+        void push(const Levels& levels, const Sample* samples, int numSamples);
+
+        // editor: start consuming, discarding anything a previous editor left queued
+        void attach();
+
+        // editor: stop consuming, the audio thread stops pushing from its next block
+        void detach() { attached.store(false, std::memory_order_release); }
+
+        // audio thread: false while no editor would drain the queues
+        bool isAttached() const { return attached.load(std::memory_order_acquire); }
+
+        // editor: take the oldest queued reading, false when empty
+        bool popLevels(Levels& levels);
+
+        // editor: take up to maxSamples queued samples, returns how many were copied
+        int popSamples(float* destination, int maxSamples);
+
+    private:
+        std::atomic<double> sampleRate { 44100.0 };
+        std::atomic<bool> attached { false };
+
+        juce::AbstractFifo levelFifo { LEVEL_CAPACITY };
+        std::array<Levels, LEVEL_CAPACITY> levelSlots;
+
+        juce::AbstractFifo sampleFifo { SAMPLE_CAPACITY };
+        std::vector<float> sampleSlots;
+};
@@ -0,0 +1,210 @@
+# include "MeterPanel.h"
+
+MeterPanel::MeterPanel(MeterFeed& feedRef)
+    : feed(feedRef),
+      history((size_t)FFT_SIZE, 0.0f),
+      fftData((size_t)(2 * FFT_SIZE), 0.0f),
+      incoming((size_t)MeterFeed::SAMPLE_CAPACITY, 0.0f)
+{
+    bandDb.fill(SPECTRUM_FLOOR_DB);
+    setOpaque(false);
+    feed.attach();
+    startTimerHz(REFRESH_HZ);
+}
+
+MeterPanel::~MeterPanel()
+{
+    stopTimer();
+    feed.detach();
+}
+
+void MeterPanel::resized()
+{
+    auto bounds = getLocalBounds();
+    meterArea = bounds.removeFromLeft(METER_AREA_WIDTH);
+    spectrumArea = bounds.withTrimmedLeft(6);
+}
+
+bool MeterPanel::updateBallistics(float& displayedDb, float newDb, float decayDb, float floorDb)
+{
+    float next = juce::jmax(newDb, displayedDb - decayDb, floorDb);
+    bool changed = std::abs(next - displayedDb) > 0.05f;
+    displayedDb = next;
+    return changed;
+}
+
+void MeterPanel::timerCallback()
+{
+    // strongest reading since the last tick
+    MeterFeed::Levels levels, newest;
+    bool haveLevels = false;
+    while (feed.popLevels(newest))
+    {
+        levels.inputPeak = juce::jmax(levels.inputPeak, newest.inputPeak);
+        levels.inputRms = juce::jmax(levels.inputRms, newest.inputRms);
+        levels.outputPeak = juce::jmax(levels.outputPeak, newest.outputPeak);
+        levels.outputRms = juce::jmax(levels.outputRms, newest.outputRms);
+        levels.clipperPeak = juce::jmax(levels.clipperPeak, newest.clipperPeak);
+        haveLevels = true;
+    }
+
+    bool metersChanged = false;
+    auto toDb = [](float gain) { return juce::Decibels::gainToDecibels(gain, METER_FLOOR_DB); };
+    metersChanged |= updateBallistics(inputPeakDb, toDb(levels.inputPeak), METER_DECAY_DB, METER_FLOOR_DB);
+    metersChanged |= updateBallistics(inputRmsDb, toDb(levels.inputRms), METER_DECAY_DB, METER_FLOOR_DB);
+    metersChanged |= updateBallistics(outputPeakDb, toDb(levels.outputPeak), METER_DECAY_DB, METER_FLOOR_DB);
+    metersChanged |= updateBallistics(outputRmsDb, toDb(levels.outputRms), METER_DECAY_DB, METER_FLOOR_DB);
+
+    // tanh(1) is already 24 % below linear, call that clipping
+    if (haveLevels && levels.clipperPeak > 1.0f)
+    {
+        metersChanged |= clipHoldTicks == 0;
+        clipHoldTicks = CLIP_HOLD_TICKS;
+    }
+    else if (clipHoldTicks > 0)
+    {
+        --clipHoldTicks;
+        metersChanged |= clipHoldTicks == 0;
+    }
+
+    // append new output samples to the circular history
+    int numIncoming = feed.popSamples(incoming.data(), (int)incoming.size());
+    for (int i = juce::jmax(0, numIncoming - FFT_SIZE); i < numIncoming; ++i)
+    {
+        history[(size_t)historyPosition] = incoming[(size_t)i];
+        historyPosition = (historyPosition + 1) % FFT_SIZE;
+    }
+
+    // the FFT only runs when there is new audio
+    bool spectrumChanged = numIncoming > 0 && updateSpectrum();
+
+    // dirty-rect repaints only
+    if (metersChanged)
+        repaint(meterArea);
+    if (spectrumChanged)
+        repaint(spectrumArea);
+}
+
+bool MeterPanel::updateSpectrum()
+{
+    // oldest sample first, then window and transform
+    for (int i = 0; i < FFT_SIZE; ++i)
+        fftData[(size_t)i] = history[(size_t)((historyPosition + i) % FFT_SIZE)];
+    std::fill(fftData.begin() + FFT_SIZE, fftData.end(), 0.0f);
+
+    window.multiplyWithWindowingTable(fftData.data(), (size_t)FFT_SIZE);
+    fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+    // log-spaced bands from MIN_FREQUENCY to nyquist, each takes its strongest bin
+    const float nyquist = (float)feed.getSampleRate() * 0.5f;
+    const float binWidth = nyquist / (float)(FFT_SIZE / 2);
+    const float ratio = nyquist / MIN_FREQUENCY;
+    const float normalisation = 4.0f / (float)FFT_SIZE;   // full-scale sine at 0 dB through the Hann window
+
+    bool changed = false;
+    for (int band = 0; band < NUM_BANDS; ++band)
+    {
+        float lowFrequency = MIN_FREQUENCY * std::pow(ratio, (float)band / (float)NUM_BANDS);
+        float highFrequency = MIN_FREQUENCY * std::pow(ratio, (float)(band + 1) / (float)NUM_BANDS);
+        int lowBin = juce::jlimit(1, FFT_SIZE / 2 - 1, (int)(lowFrequency / binWidth));
+        int highBin = juce::jlimit(lowBin, FFT_SIZE / 2 - 1, (int)(highFrequency / binWidth));
+
+        float magnitude = 0.0f;
+        for (int bin = lowBin; bin <= highBin; ++bin)
+            magnitude = juce::jmax(magnitude, fftData[(size_t)bin]);
+
+        float levelDb = juce::Decibels::gainToDecibels(magnitude * normalisation, SPECTRUM_FLOOR_DB);
+        changed |= updateBallistics(bandDb[(size_t)band], levelDb, SPECTRUM_DECAY_DB, SPECTRUM_FLOOR_DB);
+    }
+
+    return changed;
+}
+
+void MeterPanel::paint(juce::Graphics& g)
+{
+    auto clip = g.getClipBounds();
+
+    if (clip.intersects(meterArea))
+        drawMeters(g);
+    if (clip.intersects(spectrumArea))
+        drawSpectrum(g);
+}
+
+void MeterPanel::drawMeterBar(juce::Graphics& g, juce::Rectangle<int> bounds, float rmsDb, float peakDb, const juce::String& label)
+{
+    auto labelArea = bounds.removeFromBottom(14);
+    g.setColour(juce::Colours::white);
+    g.setFont(juce::Font(11.0f));
+    g.drawText(label, labelArea, juce::Justification::centred);
+
+    g.setColour(juce::Colours::black.withAlpha(0.6f));
+    g.fillRect(bounds);
+
+    auto toY = [&](float db)
+    {
+        float proportion = juce::jlimit(0.0f, 1.0f, juce::jmap(db, METER_FLOOR_DB, METER_CEILING_DB, 0.0f, 1.0f));
+        return (float)bounds.getBottom() - proportion * (float)bounds.getHeight();
+    };
+
+    // RMS body, peak line on top
+    g.setColour(rmsDb > 0.0f ? juce::Colours::orange : juce::Colour(0xffd4af37));
+    g.fillRect(juce::Rectangle<float>((float)bounds.getX(), toY(rmsDb), (float)bounds.getWidth(), (float)bounds.getBottom() - toY(rmsDb)));
+
+    g.setColour(peakDb > 0.0f ? juce::Colours::red : juce::Colours::white);
+    g.fillRect(juce::Rectangle<float>((float)bounds.getX(), toY(peakDb) - 1.0f, (float)bounds.getWidth(), 2.0f));
+
+    // 0 dBFS mark
+    g.setColour(juce::Colours::white.withAlpha(0.4f));
+    g.drawHorizontalLine(juce::roundToInt(toY(0.0f)), (float)bounds.getX(), (float)bounds.getRight());
+}
+
+void MeterPanel::drawMeters(juce::Graphics& g)
+{
+    auto area = meterArea.reduced(4);
+
+    // clip indicator for the tanh stage
+    auto ledArea = area.removeFromTop(CLIP_LED_SIZE + 4);
+    auto led = ledArea.removeFromLeft(CLIP_LED_SIZE).toFloat();
+    g.setColour(clipHoldTicks > 0 ? juce::Colours::red : juce::Colours::darkred.withAlpha(0.5f));
+    g.fillEllipse(led);
+    g.setColour(juce::Colours::white);
+    g.setFont(juce::Font(11.0f));
+    g.drawText("CLIP", ledArea.withTrimmedLeft(4), juce::Justification::centredLeft);
+
+    auto barWidth = (area.getWidth() - 6) / 2;
+    drawMeterBar(g, area.removeFromLeft(barWidth), inputRmsDb, inputPeakDb, "IN");
+    area.removeFromLeft(6);
+    drawMeterBar(g, area.removeFromLeft(barWidth), outputRmsDb, outputPeakDb, "OUT");
+}
+
+void MeterPanel::drawSpectrum(juce::Graphics& g)
+{
+    auto bounds = spectrumArea.reduced(4).toFloat();
+
+    g.setColour(juce::Colours::black.withAlpha(0.6f));
+    g.fillRect(bounds);
+
+    juce::Path spectrum;
+    float bandWidth = bounds.getWidth() / (float)NUM_BANDS;
+    for (int band = 0; band < NUM_BANDS; ++band)
+    {
+        float proportion = juce::jmap(bandDb[(size_t)band], SPECTRUM_FLOOR_DB, SPECTRUM_CEILING_DB, 0.0f, 1.0f);
+        float x = bounds.getX() + ((float)band + 0.5f) * bandWidth;
+        float y = bounds.getBottom() - juce::jlimit(0.0f, 1.0f, proportion) * bounds.getHeight();
+
+        if (band == 0)
+            spectrum.startNewSubPath(bounds.getX(), y);
+        spectrum.lineTo(x, y);
+    }
+    spectrum.lineTo(bounds.getRight(), spectrum.getCurrentPosition().y);
+
+    juce::Path fill(spectrum);
+    fill.lineTo(bounds.getBottomRight());
+    fill.lineTo(bounds.getBottomLeft());
+    fill.closeSubPath();
+
+    g.setColour(juce::Colour(0xffd4af37).withAlpha(0.25f));
+    g.fillPath(fill);
+    g.setColour(juce::Colour(0xffd4af37));
+    g.strokePath(spectrum, juce::PathStrokeType(1.5f));
+}
@@ -0,0 +1,81 @@
+# pragma once
+
+# include <array>
+# include <vector>
+# include <juce_gui_basics/juce_gui_basics.h>
+# include <juce_dsp/juce_dsp.h>
+# include "MeterFeed.h"
+
+// input/output level meters, a clip indicator for the tanh stage and an output
+// spectrum. everything runs on a message-thread timer that drains the
+// MeterFeed; only the regions whose readings changed are repainted.
+class MeterPanel : public juce::Component, private juce::Timer
+{
+    public:
+        // constructor and destructor
+        explicit MeterPanel(MeterFeed& feedRef);
+        ~MeterPanel() override;
+
+        // window resize handler
+        void resized() override;
+
+        // window paint handler
+        void paint(juce::Graphics& g) override;
+
+    private:
+        // drain the feed, update ballistics and the spectrum, repaint what changed
+        void timerCallback() override;
+
+        // FFT
+        static constexpr int FFT_ORDER = 11;
+        static constexpr int FFT_SIZE = 1 << FFT_ORDER;
+        static constexpr int NUM_BANDS = 48;
+        static constexpr float MIN_FREQUENCY = 40.0f;    // Hz
+
+        // display ranges and ballistics, per timer tick at 30 Hz
+        static constexpr int REFRESH_HZ = 30;
+        static constexpr float METER_FLOOR_DB = -60.0f;
+        static constexpr float METER_CEILING_DB = 6.0f;
+        static constexpr float SPECTRUM_FLOOR_DB = -90.0f;
+        static constexpr float SPECTRUM_CEILING_DB = 0.0f;
+        static constexpr float METER_DECAY_DB = 1.5f;
+        static constexpr float SPECTRUM_DECAY_DB = 2.0f;
+        static constexpr int CLIP_HOLD_TICKS = REFRESH_HZ;   // clip indicator stays lit for a second
+
+        // layout constants
+        static constexpr int METER_AREA_WIDTH = 90;
+        static constexpr int CLIP_LED_SIZE = 10;
+
+        MeterFeed& feed;
+
+        // displayed meter values in dB
+        float inputPeakDb = METER_FLOOR_DB;
+        float inputRmsDb = METER_FLOOR_DB;
+        float outputPeakDb = METER_FLOOR_DB;
+        float outputRmsDb = METER_FLOOR_DB;
+        int clipHoldTicks = 0;
+
+        // spectrum analysis
+        juce::dsp::FFT fft { FFT_ORDER };
+        juce::dsp::WindowingFunction<float> window { (size_t)FFT_SIZE, juce::dsp::WindowingFunction<float>::hann };
+        std::vector<float> history;      // last FFT_SIZE output samples, circular
+        int historyPosition = 0;
+        std::vector<float> fftData;      // 2 * FFT_SIZE work buffer
+        std::vector<float> incoming;     // drain buffer
+        std::array<float, NUM_BANDS> bandDb;
+
+        // regions repainted independently
+        juce::Rectangle<int> meterArea;
+        juce::Rectangle<int> spectrumArea;
+
+        // helper to decay a displayed value towards a new reading
+        static bool updateBallistics(float& displayedDb, float newDb, float decayDb, float floorDb);
+
+        // helper to run the FFT over the history and refresh the bands
+        bool updateSpectrum();
+
+        // helpers to draw each region
+        void drawMeters(juce::Graphics& g);
+        void drawSpectrum(juce::Graphics& g);
+        void drawMeterBar(juce::Graphics& g, juce::Rectangle<int> bounds, float rmsDb, float peakDb, const juce::String& label);
+};
@@ -0,0 +1,166 @@
+# include "PedalImageCache.h"
+# include "BinaryData.h"
+
+# include <cstring>
+
+PedalImageCache::PedalImageCache()
+{
+    // baked at build time, so this is a copy rather than a PNG decode
+    knobImage = loadBakedImage(BinaryData::knob_odimg, BinaryData::knob_odimgSize);
+    bypassImage = loadBakedImage(BinaryData::bypass_up_odimg, BinaryData::bypass_up_odimgSize);
+}
+
+juce::Image PedalImageCache::loadBakedImage(const void* data, int sizeInBytes)
+{
+    // "ODIM", uint32 width, uint32 height, premultiplied B, G, R, A rows (see tools/image_baker)
+    constexpr int HEADER_SIZE = 12;
+    const auto* bytes = static_cast<const juce::uint8*>(data);
+    if (sizeInBytes < HEADER_SIZE || std::memcmp(bytes, "ODIM", 4) != 0)
+        return {};
+
+    const int width = (int)juce::ByteOrder::littleEndianInt(bytes + 4);
+    const int height = (int)juce::ByteOrder::littleEndianInt(bytes + 8);
+    if (width <= 0 || height <= 0 || (juce::int64)sizeInBytes < HEADER_SIZE + (juce::int64)width * height * 4)
+        return {};
+
+    juce::Image image(juce::Image::ARGB, width, height, false);
+    juce::Image::BitmapData pixels(image, juce::Image::BitmapData::writeOnly);
+    const juce::uint8* source = bytes + HEADER_SIZE;
+
+    for (int y = 0; y < height; ++y, source += width * 4)
+    {
+        auto* destination = pixels.getLinePointer(y);
+
+    # if JUCE_LITTLE_ENDIAN
+        // PixelARGB is stored B, G, R, A here, rows copy as they are
+        if (pixels.pixelStride == 4)
+        {
+            std::memcpy(destination, source, (size_t)width * 4);
+            continue;
+        }
+    # endif
+
+        for (int x = 0; x < width; ++x)
+        {
+            const juce::uint8* p = source + x * 4;
+            reinterpret_cast<juce::PixelARGB*>(destination + x * pixels.pixelStride)->setARGB(p[3], p[2], p[1], p[0]);
+        }
+    }
+
+    return image;
+}
+
+const juce::Image& PedalImageCache::getBakedBody(bool lit)
+{
+    // the 2x variant is the source for any size that was not baked
+    juce::Image& body = lit ? pedalBodyOnImage : pedalBodyOffImage;
+    if (!body.isValid())
+        body = lit ? loadBakedImage(BinaryData::pedal_body_on_2x_odimg, BinaryData::pedal_body_on_2x_odimgSize)
+                   : loadBakedImage(BinaryData::pedal_body_off_2x_odimg, BinaryData::pedal_body_off_2x_odimgSize);
+    return body;
+}
+
+float PedalImageCache::getPhysicalScale(juce::Graphics& g)
+{
+    return juce::jmax(1.0f, g.getInternalContext().getPhysicalPixelScaleFactor());
+}
+
+void PedalImageCache::drawKnob(juce::Graphics& g, int x, int y, int size,
+                               float proportion, float startAngle, float endAngle)
+{
+    if (!knobImage.isValid() || size <= 0)
+        return;
+
+    const int framePixels = juce::roundToInt((float)size * getPhysicalScale(g));
+    Filmstrip& strip = getFilmstrip(framePixels, startAngle, endAngle);
+
+    const int frame = juce::jlimit(0, NUM_KNOB_FRAMES - 1, juce::roundToInt(proportion * (float)(NUM_KNOB_FRAMES - 1)));
+    if (!strip.frames[(size_t)frame].isValid())
+        renderKnobFrame(strip, frame);
+
+    // physical-size source into logical-size target is a 1:1 blit on screen
+    g.drawImage(strip.frames[(size_t)frame], x, y, size, size, 0, 0, framePixels, framePixels);
+}
+
+void PedalImageCache::drawPedalBody(juce::Graphics& g, juce::Rectangle<int> bounds, bool lit)
+{
+    const float scale = getPhysicalScale(g);
+    const juce::Image& body = getScaledBody(juce::roundToInt((float)bounds.getWidth() * scale),
+                                            juce::roundToInt((float)bounds.getHeight() * scale), lit);
+    if (!body.isValid())
+        return;
+
+    g.drawImage(body, bounds.getX(), bounds.getY(), bounds.getWidth(), bounds.getHeight(),
+                0, 0, body.getWidth(), body.getHeight());
+}
+
+PedalImageCache::Filmstrip& PedalImageCache::getFilmstrip(int framePixels, float startAngle, float endAngle)
+{
+    for (auto& strip : filmstrips)
+    {
+        if (strip.framePixels == framePixels && strip.startAngle == startAngle && strip.endAngle == endAngle)
+            return strip;
+    }
+
+    if (filmstrips.size() >= MAX_CACHED_SIZES)
+        filmstrips.erase(filmstrips.begin());
+
+    Filmstrip strip;
+    strip.framePixels = framePixels;
+    strip.startAngle = startAngle;
+    strip.endAngle = endAngle;
+    strip.frames.resize(NUM_KNOB_FRAMES);
+
+    filmstrips.push_back(std::move(strip));
+    return filmstrips.back();
+}
+
+const juce::Image& PedalImageCache::getScaledBody(int width, int height, bool lit)
+{
+    for (const auto& body : scaledBodies)
+    {
+        if (body.width == width && body.height == height && body.lit == lit)
+            return body.image;
+    }
+
+    if (scaledBodies.size() >= MAX_CACHED_SIZES)
+        scaledBodies.erase(scaledBodies.begin());
+
+    ScaledBody body;
+    body.width = width;
+    body.height = height;
+    body.lit = lit;
+
+    // the editor's own 1x and 2x sizes were baked, anything else is resampled once
+    if (width == ODPEDAL_BAKED_BODY_WIDTH && height == ODPEDAL_BAKED_BODY_HEIGHT)
+        body.image = lit ? loadBakedImage(BinaryData::pedal_body_on_1x_odimg, BinaryData::pedal_body_on_1x_odimgSize)
+                         : loadBakedImage(BinaryData::pedal_body_off_1x_odimg, BinaryData::pedal_body_off_1x_odimgSize);
+    else if (width == 2 * ODPEDAL_BAKED_BODY_WIDTH && height == 2 * ODPEDAL_BAKED_BODY_HEIGHT)
+        body.image = getBakedBody(lit);
+    else if (getBakedBody(lit).isValid() && width > 0 && height > 0)
+        body.image = getBakedBody(lit).rescaled(width, height, juce::Graphics::highResamplingQuality);
+
+    scaledBodies.push_back(std::move(body));
+    return scaledBodies.back().image;
+}
+
+void PedalImageCache::renderKnobFrame(Filmstrip& strip, int frame)
+{
+    const float pixels = (float)strip.framePixels;
+    const float proportion = (float)frame / (float)(NUM_KNOB_FRAMES - 1);
+    const float angle = strip.startAngle + proportion * (strip.endAngle - strip.startAngle);
+
+    juce::Image& image = strip.frames[(size_t)frame];
+    image = juce::Image(juce::Image::ARGB, strip.framePixels, strip.framePixels, true);
+
+    juce::Graphics g(image);
+    g.setImageResamplingQuality(juce::Graphics::highResamplingQuality);
+
+    // same transform the editor used to apply on every repaint
+    g.drawImageTransformed(knobImage,
+                           juce::AffineTransform::translation(-knobImage.getWidth() / 2.0f, -knobImage.getHeight() / 2.0f)
+                               .scaled(pixels / (float)knobImage.getWidth())
+                               .rotated(angle, 0.0f, 0.0f)
+                               .translated(pixels * 0.5f, pixels * 0.5f),
+                           false);
+}
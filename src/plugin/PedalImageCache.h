@@ -0,0 +1,80 @@
+# pragma once
+
+# include <juce_gui_basics/juce_gui_basics.h>
+# include <vector>
+
+// pre-rendered editor artwork, shared by every editor instance through
+// juce::SharedResourcePointer. the sources are baked at build time into raw
+// premultiplied pixels (tools/image_baker), so nothing is PNG-decoded. knob
+// rotations are pre-rendered per step and the pedal body is pre-scaled, both at
+// the physical pixel size they are shown at, so paint calls are plain 1:1 blits.
+// entries are keyed by physical size and only re-rendered when the component
+// size or the display scale changes. message thread only.
+class PedalImageCache
+{
+    public:
+        // constructor, copies the baked knob and footswitch pixels
+        PedalImageCache();
+
+        // draw the knob rotated to proportion of [startAngle, endAngle], filling a square of size
+        void drawKnob(juce::Graphics& g, int x, int y, int size,
+                      float proportion, float startAngle, float endAngle);
+
+        // draw the pedal body stretched to the given bounds
+        void drawPedalBody(juce::Graphics& g, juce::Rectangle<int> bounds, bool lit);
+
+        // bypass footswitch artwork at its original size
+        const juce::Image& getBypassImage() const { return bypassImage; }
+
+        // decode a build-time baked .odimg blob, invalid image on malformed data
+        static juce::Image loadBakedImage(const void* data, int sizeInBytes);
+
+    private:
+        // rotation steps across the knob's travel
+        static constexpr int NUM_KNOB_FRAMES = 128;
+
+        // distinct sizes kept per image before the oldest is dropped
+        static constexpr size_t MAX_CACHED_SIZES = 6;
+
+        // one image per rotation step, allocated and rendered the first time it
+        // is shown, so a size the knobs only pass through costs a few frames
+        struct Filmstrip
+        {
+            int framePixels = 0;
+            float startAngle = 0.0f;
+            float endAngle = 0.0f;
+            std::vector<juce::Image> frames;   // invalid until rendered
+        };
+
+        struct ScaledBody
+        {
+            int width = 0;
+            int height = 0;
+            bool lit = true;
+            juce::Image image;
+        };
+
+        // source artwork, the bodies are the 2x bakes and load on first use
+        juce::Image knobImage;
+        juce::Image bypassImage;
+        juce::Image pedalBodyOnImage;
+        juce::Image pedalBodyOffImage;
+
+        std::vector<Filmstrip> filmstrips;
+        std::vector<ScaledBody> scaledBodies;
+
+        // helper to find or create the filmstrip for a physical size and travel
+        Filmstrip& getFilmstrip(int framePixels, float startAngle, float endAngle);
+
+        // helper to load the 2x baked body on first use
+        const juce::Image& getBakedBody(bool lit);
+
+        // helper to find or create the pre-scaled body for a physical size
+        const juce::Image& getScaledBody(int width, int height, bool lit);
+
+        // allocate and render one rotation step of the filmstrip
+        void renderKnobFrame(Filmstrip& strip, int frame);
+
+        // helper for the physical pixels per logical pixel of a graphics context
+        static float getPhysicalScale(juce::Graphics& g);
+};
@@ -1,8 +1,7 @@
 # include "PluginEditor.h"
-# include "BinaryData.h"
 
 PluginEditor::PluginEditor(PluginProcessor& processorRef)
-    : AudioProcessorEditor(processorRef), processor(processorRef)
+    : AudioProcessorEditor(processorRef), processor(processorRef), meterPanel(processorRef.getMeterFeed())
 {
     // set window size (fixed, non-resizable)
     setSize(WINDOW_WIDTH, WINDOW_HEIGHT);
@@ -13,11 +12,10 @@ PluginEditor::PluginEditor(PluginProcessor& processorRef)
     levelSlider.setLookAndFeel(&goldKnobLAF);
     bypassButton.setLookAndFeel(&goldButtonLAF);
 
-    // sliders
+    // sliders, ranges come from the parameter registry
     driveSlider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
     driveSlider.setTextBoxStyle(juce::Slider::TextBoxAbove, false, 60, 20);
-    driveSlider.setRange(0.0f, 24.0f, 0.1f);
-    driveSlider.setValue(0.0f);
+    applyParameterRange(driveSlider, ODPedalParameters::ParameterIndex::Drive);
     driveSlider.setNumDecimalPlacesToDisplay(2);
     driveSlider.setColour(juce::Slider::textBoxOutlineColourId, juce::Colours::transparentBlack);
     driveSlider.setColour(juce::Slider::textBoxTextColourId, juce::Colours::white);
@@ -25,8 +23,7 @@ PluginEditor::PluginEditor(PluginProcessor& processorRef)
 
     toneSlider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
     toneSlider.setTextBoxStyle(juce::Slider::TextBoxAbove, false, 60, 20);
-    toneSlider.setRange(800.0f, 8000.0f, 1.0f);
-    toneSlider.setValue(800.0f);
+    applyParameterRange(toneSlider, ODPedalParameters::ParameterIndex::Tone);
     toneSlider.setNumDecimalPlacesToDisplay(2);
     toneSlider.setColour(juce::Slider::textBoxOutlineColourId, juce::Colours::transparentBlack);
     toneSlider.setColour(juce::Slider::textBoxTextColourId, juce::Colours::white);
@@ -34,8 +31,7 @@ PluginEditor::PluginEditor(PluginProcessor& processorRef)
 
     levelSlider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
     levelSlider.setTextBoxStyle(juce::Slider::TextBoxAbove, false, 60, 20);
-    levelSlider.setRange(-12.0f, 12.0f, 0.1f);
-    levelSlider.setValue(0.0f);
+    applyParameterRange(levelSlider, ODPedalParameters::ParameterIndex::Level);
     levelSlider.setNumDecimalPlacesToDisplay(2);
     levelSlider.setColour(juce::Slider::textBoxOutlineColourId, juce::Colours::transparentBlack);
     levelSlider.setColour(juce::Slider::textBoxTextColourId, juce::Colours::white);
@@ -71,6 +67,63 @@ PluginEditor::PluginEditor(PluginProcessor& processorRef)
     bypassButton.setColour(juce::ComboBox::outlineColourId, juce::Colours::transparentBlack);
     addAndMakeVisible(bypassButton);
 
+    // program row
+    programBox.onChange = [this]()
+    {
+        const int index = programBox.getSelectedId() - 1;
+        if (index >= 0 && index != processor.getCurrentProgram())
+            processor.setCurrentProgram(index);
+    };
+    updateProgramBox();
+    addAndMakeVisible(programBox);
+
+    saveProgramButton.onClick = [this]()
+    {
+        // factory programs are read-only, so saving always picks a user slot
+        juce::PopupMenu menu;
+        for (int index = ODPedalPrograms::numFactoryPrograms; index < ODPedalPrograms::numPrograms; ++index)
+            menu.addItem(index + 1, "Save to " + processor.getProgramName(index));
+
+        menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&saveProgramButton),
+            [this](int result)
+            {
+                if (result > 0)
+                    processor.storeUserProgram(result - 1);
+            });
+    };
+    addAndMakeVisible(saveProgramButton);
+
+    touchButton.setColour(juce::ToggleButton::textColourId, juce::Colours::white);
+    addAndMakeVisible(touchButton);
+
+    processor.addChangeListener(this);
+
+    // cabinet row
+    cabinetButton.setColour(juce::ToggleButton::textColourId, juce::Colours::white);
+    addAndMakeVisible(cabinetButton);
+
+    loadImpulseButton.onClick = [this]()
+    {
+        // async so the host's message loop keeps running while the dialog is open
+        impulseChooser = std::make_unique<juce::FileChooser>("Load cabinet impulse", juce::File(), "*.wav;*.aif;*.aiff;*.flac");
+        impulseChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+            [this](const juce::FileChooser& chooser)
+            {
+                const juce::File file = chooser.getResult();
+                if (file != juce::File() && processor.loadCabinetImpulse(file))
+                    updateImpulseLabel();
+            });
+    };
+    addAndMakeVisible(loadImpulseButton);
+
+    impulseLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+    impulseLabel.setFont(juce::Font(13.0f));
+    updateImpulseLabel();
+    addAndMakeVisible(impulseLabel);
+
+    // meters
+    addAndMakeVisible(meterPanel);
+
     // attachments
     driveAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
         processor.apvts, ODPedalParameters::DRIVE_ID, driveSlider
@@ -84,6 +137,12 @@ PluginEditor::PluginEditor(PluginProcessor& processorRef)
     bypassAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
         processor.apvts, ODPedalParameters::BYPASS_ID, bypassButton
     );
+    cabinetAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        processor.apvts, ODPedalParameters::CABINET_ID, cabinetButton
+    );
+    touchAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        processor.apvts, ODPedalParameters::TOUCH_ID, touchButton
+    );
 
     // set slider text formatting functions
     driveSlider.textFromValueFunction = [this](double v) {
@@ -107,6 +166,7 @@ PluginEditor::PluginEditor(PluginProcessor& processorRef)
 
 PluginEditor::~PluginEditor()
 {
+    processor.removeChangeListener(this);
     bypassButton.removeListener(this);
     driveSlider.setLookAndFeel(nullptr);
     toneSlider.setLookAndFeel(nullptr);
@@ -123,6 +183,28 @@ void PluginEditor::buttonClicked(juce::Button* button)
     }
 }
 
+void PluginEditor::changeListenerCallback(juce::ChangeBroadcaster* source)
+{
+    juce::ignoreUnused(source);
+
+    // a restored session may also bring a different impulse
+    updateProgramBox();
+    updateImpulseLabel();
+}
+
+void PluginEditor::updateProgramBox()
+{
+    programBox.clear(juce::dontSendNotification);
+    for (int index = 0; index < ODPedalPrograms::numPrograms; ++index)
+    {
+        if (index == ODPedalPrograms::numFactoryPrograms)
+            programBox.addSeparator();
+        programBox.addItem(processor.getProgramName(index), index + 1);
+    }
+
+    programBox.setSelectedId(processor.getCurrentProgram() + 1, juce::dontSendNotification);
+}
+
 void PluginEditor::resized()
 {
     // knob sizes (25% reduction from previous)
@@ -144,17 +226,35 @@ void PluginEditor::resized()
 
     // bypass button
     bypassButton.setBounds(BYPASS_BUTTON_X, BYPASS_BUTTON_Y, BYPASS_BUTTON_WIDTH, BYPASS_BUTTON_HEIGHT);
-}
 
+    // program row: below the pedal
+    juce::Rectangle<int> programRow(MARGIN, PEDAL_HEIGHT + 2 * MARGIN, PEDAL_WIDTH, PROGRAM_ROW_HEIGHT);
+    saveProgramButton.setBounds(programRow.removeFromRight(SAVE_BUTTON_WIDTH));
+    touchButton.setBounds(programRow.removeFromRight(TOUCH_BUTTON_WIDTH).withTrimmedLeft(MARGIN));
+    programBox.setBounds(programRow.withTrimmedRight(MARGIN));
+
+    // cabinet row: below the program row
+    juce::Rectangle<int> cabinetRow(MARGIN, PEDAL_HEIGHT + PROGRAM_ROW_HEIGHT + 3 * MARGIN, PEDAL_WIDTH, CABINET_ROW_HEIGHT);
+    cabinetButton.setBounds(cabinetRow.removeFromLeft(CABINET_BUTTON_WIDTH));
+    loadImpulseButton.setBounds(cabinetRow.removeFromLeft(LOAD_BUTTON_WIDTH));
+    impulseLabel.setBounds(cabinetRow.withTrimmedLeft(MARGIN));
+
+    // meter panel: below the cabinet row
+    meterPanel.setBounds(MARGIN, PEDAL_HEIGHT + PROGRAM_ROW_HEIGHT + CABINET_ROW_HEIGHT + 4 * MARGIN, PEDAL_WIDTH, METER_PANEL_HEIGHT);
+}
 
-void PluginEditor::loadPedalBodyImages()
+void PluginEditor::updateImpulseLabel()
 {
-    if (pedalBodyOnImage.isValid() && pedalBodyOffImage.isValid())
-        return;
+    const juce::String path = processor.getCabinetImpulsePath();
+    impulseLabel.setText(path.isEmpty() ? juce::String("No impulse loaded") : juce::File(path).getFileName(),
+                         juce::dontSendNotification);
+}
 
-    // load pedal body images from binary resources
-    pedalBodyOnImage = juce::ImageCache::getFromMemory(BinaryData::pedal_body_on_png, BinaryData::pedal_body_on_pngSize);
-    pedalBodyOffImage = juce::ImageCache::getFromMemory(BinaryData::pedal_body_off_png, BinaryData::pedal_body_off_pngSize);
+void PluginEditor::applyParameterRange(juce::Slider& slider, ODPedalParameters::ParameterIndex index)
+{
+    const auto& spec = ODPedalParameters::getSpec(index);
+    slider.setNormalisableRange({ spec.minValue, spec.maxValue, spec.interval, spec.skew });
+    slider.setValue(spec.defaultValue);
 }
 
 void PluginEditor::paint(juce::Graphics& g)
@@ -162,15 +262,6 @@ void PluginEditor::paint(juce::Graphics& g)
     // dark grey background
     g.fillAll(juce::Colour::fromFloatRGBA(0.15f, 0.15f, 0.15f, 1.0f));
 
-    // load and draw pedal body image based on LED state
-    loadPedalBodyImages();
-    auto imageToUse = isLit ? pedalBodyOnImage : pedalBodyOffImage;
-    if (imageToUse.isValid())
-    {
-        // scale image to fit pedal bounds
-        g.drawImageWithin(imageToUse, 
-                         MARGIN, MARGIN, PEDAL_WIDTH, PEDAL_HEIGHT,
-                         juce::RectanglePlacement::stretchToFit,
-                         false);
-    }
+    // draw pedal body image based on LED state, pre-scaled for this display
+    imageCache->drawPedalBody(g, { MARGIN, MARGIN, PEDAL_WIDTH, PEDAL_HEIGHT }, isLit);
 }
@@ -4,8 +4,9 @@
 # include <juce_audio_processors/juce_audio_processors.h>
 # include "PluginProcessor.h"
 # include "CustomLookAndFeel.h"
+# include "MeterPanel.h"
 
-class PluginEditor : public juce::AudioProcessorEditor, public juce::Button::Listener
+class PluginEditor : public juce::AudioProcessorEditor, public juce::Button::Listener, public juce::ChangeListener
 {
     public:
         // constructor and destructor
@@ -20,21 +21,25 @@ class PluginEditor : public juce::AudioProcessorEditor, public juce::Button::Lis
         
         // button listener to update LED state
         void buttonClicked(juce::Button* button) override;
+
+        // the processor's programs or impulse changed, from the host or a restored session
+        void changeListenerCallback(juce::ChangeBroadcaster* source) override;
     
     private:
         // processor
         PluginProcessor& processor;
 
-        // pedal body images
-        juce::Image pedalBodyOnImage;
-        juce::Image pedalBodyOffImage;
-        void loadPedalBodyImages();
+        // pre-scaled pedal body images, shared with every other editor
+        juce::SharedResourcePointer<PedalImageCache> imageCache;
 
         // sliders
         juce::Slider driveSlider;
         juce::Slider toneSlider;
         juce::Slider levelSlider;
 
+        // helper to take a slider's range and default from the parameter registry
+        static void applyParameterRange(juce::Slider& slider, ODPedalParameters::ParameterIndex index);
+
         // labels
         juce::Label driveLabel;
         juce::Label toneLabel;
@@ -42,6 +47,27 @@ class PluginEditor : public juce::AudioProcessorEditor, public juce::Button::Lis
 
         // bypass button
         juce::ToggleButton bypassButton;
+
+        // program row: factory and user programs, saving to a user slot and the
+        // touch-sensitive mode, which programs store along with the knobs
+        juce::ComboBox programBox;
+        juce::TextButton saveProgramButton { "Save..." };
+        juce::ToggleButton touchButton { "Touch" };
+
+        // helper to refill the program list and show the current program
+        void updateProgramBox();
+
+        // cabinet row: on/off, impulse file chooser and the loaded file's name
+        juce::ToggleButton cabinetButton { "Cab" };
+        juce::TextButton loadImpulseButton { "Load IR..." };
+        juce::Label impulseLabel;
+        std::unique_ptr<juce::FileChooser> impulseChooser;
+
+        // helper to show the loaded impulse's file name
+        void updateImpulseLabel();
+
+        // level meters, clip indicator and spectrum below the pedal
+        MeterPanel meterPanel;
         
         // LED state tracker
         bool isLit = true;
@@ -51,17 +77,34 @@ class PluginEditor : public juce::AudioProcessorEditor, public juce::Button::Lis
         std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> toneAttachment;
         std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> levelAttachment;
         std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> bypassAttachment;
+        std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> cabinetAttachment;
+        std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> touchAttachment;
 
         // custom look and feel
         GoldKnobLookAndFeel goldKnobLAF;
         GoldButtonLookAndFeel goldButtonLAF;
 
         // layout constants
-        static constexpr int WINDOW_WIDTH = 350;
-        static constexpr int WINDOW_HEIGHT = 600;
         static constexpr int MARGIN = 10;
         static constexpr int PEDAL_WIDTH = 330;
         static constexpr int PEDAL_HEIGHT = 580;
+        static constexpr int PROGRAM_ROW_HEIGHT = 24;
+        static constexpr int CABINET_ROW_HEIGHT = 24;
+        static constexpr int METER_PANEL_HEIGHT = 110;
+        static constexpr int WINDOW_WIDTH = 350;
+        static constexpr int WINDOW_HEIGHT = PEDAL_HEIGHT + PROGRAM_ROW_HEIGHT + CABINET_ROW_HEIGHT + METER_PANEL_HEIGHT + 5 * MARGIN;
+
+        // program row widths of the touch and save buttons, the list takes the rest
+        static constexpr int TOUCH_BUTTON_WIDTH = 70;
+        static constexpr int SAVE_BUTTON_WIDTH = 80;
+
+        // cabinet row widths, the label takes the rest
+        static constexpr int CABINET_BUTTON_WIDTH = 60;
+        static constexpr int LOAD_BUTTON_WIDTH = 80;
+
+        // the pedal body is baked at build time for exactly this size (src/CMakeLists.txt)
+        static_assert(PEDAL_WIDTH == ODPEDAL_BAKED_BODY_WIDTH && PEDAL_HEIGHT == ODPEDAL_BAKED_BODY_HEIGHT,
+                      "update the baked pedal body size in src/CMakeLists.txt");
         
         // knob and label sizes
         static constexpr float DRIVE_LEVEL_KNOB_SIZE = 74.0f;
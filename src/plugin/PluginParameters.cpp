@@ -1,31 +1,54 @@
 # include "PluginParameters.h"
 
+juce::NormalisableRange<float> ODPedalParameters::makeRange(const ParameterSpec& spec)
+{
+    return juce::NormalisableRange<float> { spec.minValue, spec.maxValue, spec.interval, spec.skew };
+}
+
 juce::AudioProcessorValueTreeState::ParameterLayout ODPedalParameters::createParameterLayout()
 {
-    // create the parameter layout and add parameters
-    return juce::AudioProcessorValueTreeState::ParameterLayout {
-        std::make_unique<juce::AudioParameterFloat> (
-            juce::ParameterID { DRIVE_ID, 1 },
-            DRIVE_NAME,
-            juce::NormalisableRange<float> { 0.0f, 24.0f, 0.1f, 0.4f }, 0.0f,
-            juce::AudioParameterFloatAttributes().withLabel ("dB")
-        ),
-        std::make_unique<juce::AudioParameterFloat> (
-            juce::ParameterID { TONE_ID, 1 },
-            TONE_NAME,
-            juce::NormalisableRange<float> { 800.0f, 8000.0f, 1.0f, 0.35f }, 3000.0f,
-            juce::AudioParameterFloatAttributes().withLabel ("Hz")
-        ),
-        std::make_unique<juce::AudioParameterFloat> (
-            juce::ParameterID { LEVEL_ID, 1 },
-            LEVEL_NAME,
-            juce::NormalisableRange<float> { -12.0f, 12.0f, 0.1f, 0.5f }, 0.0f,
-            juce::AudioParameterFloatAttributes().withLabel ("dB")
-        ),
-        std::make_unique<juce::AudioParameterBool> (
-            juce::ParameterID { BYPASS_ID, 1 },
-            BYPASS_NAME,
-            false
-        )
-    };
+    // create the parameter layout and add one parameter per registry entry
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+
+    for (const auto& spec : registry)
+    {
+        if (spec.isToggle)
+        {
+            layout.add(std::make_unique<juce::AudioParameterBool> (
+                juce::ParameterID { spec.id, spec.versionHint },
+                spec.name,
+                spec.defaultValue > 0.5f
+            ));
+        }
+        else
+        {
+            layout.add(std::make_unique<juce::AudioParameterFloat> (
+                juce::ParameterID { spec.id, spec.versionHint },
+                spec.name,
+                makeRange(spec), spec.defaultValue,
+                juce::AudioParameterFloatAttributes().withLabel (spec.label)
+            ));
+        }
+    }
+
+    return layout;
+}
+
+void ODPedalParameters::ParameterHandles::resolve(juce::AudioProcessorValueTreeState& apvts)
+{
+    for (const auto& spec : registry)
+    {
+        values[static_cast<std::size_t>(spec.index)] = apvts.getRawParameterValue(spec.id);
+        objects[static_cast<std::size_t>(spec.index)] = apvts.getParameter(spec.id);
+        jassert(values[static_cast<std::size_t>(spec.index)] != nullptr);
+        jassert(objects[static_cast<std::size_t>(spec.index)] != nullptr);
+    }
+}
+
+void ODPedalParameters::ParameterHandles::set(ParameterIndex index, float value)
+{
+    auto* parameter = objects[static_cast<std::size_t>(index)];
+    const float normalised = parameter->convertTo0to1(value);
+    if (parameter->getValue() != normalised)
+        parameter->setValueNotifyingHost(normalised);
 }
@@ -1,21 +1,119 @@
 # pragma once
 
+# include <array>
+# include <atomic>
 # include <juce_audio_processors/juce_audio_processors.h>
 
 namespace ODPedalParameters
 {
+    // position of every parameter in the registry
+    enum class ParameterIndex
+    {
+        Drive,
+        Tone,
+        Level,
+        Bypass,
+        Cabinet,
+        Touch,
+        Count
+    };
+
+    constexpr int numParameters = static_cast<int>(ParameterIndex::Count);
+
+    // everything the layout, the audio thread and the editor need to know about a parameter
+    struct ParameterSpec
+    {
+        ParameterIndex index;
+        const char* id;
+        const char* name;
+        const char* label;
+        float minValue;
+        float maxValue;
+        float interval;
+        float skew;
+        float defaultValue;
+        bool isToggle;
+        int versionHint;   // plugin version that added the parameter (juce::ParameterID)
+        bool inPrograms;   // stored in and recalled by programs (ProgramBank.h)
+    };
+
+    // the single source of truth, in ParameterIndex order
+    constexpr std::array<ParameterSpec, numParameters> registry { {
+        { ParameterIndex::Drive,   "drive",  "Drive",   "dB", 0.0f,   24.0f,   0.1f, 0.4f,  0.0f,    false, 1, true },
+        { ParameterIndex::Tone,    "tone",   "Tone",    "Hz", 800.0f, 8000.0f, 1.0f, 0.35f, 3000.0f, false, 1, true },
+        { ParameterIndex::Level,   "level",  "Level",   "dB", -12.0f, 12.0f,   0.1f, 0.5f,  0.0f,    false, 1, true },
+        { ParameterIndex::Bypass,  "bypass", "Bypass",  "",   0.0f,   1.0f,    1.0f, 1.0f,  0.0f,    true,  1, false },
+        { ParameterIndex::Cabinet, "cab",    "Cabinet", "",   0.0f,   1.0f,    1.0f, 1.0f,  0.0f,    true,  2, true },
+        { ParameterIndex::Touch,   "touch",  "Touch",   "",   0.0f,   1.0f,    1.0f, 1.0f,  0.0f,    true,  2, true }
+    } };
+
+    // catch table rows that drift out of ParameterIndex order
+    constexpr bool registryIsOrdered()
+    {
+        for (int i = 0; i < numParameters; ++i)
+        {
+            if (static_cast<int>(registry[static_cast<std::size_t>(i)].index) != i)
+                return false;
+        }
+        return true;
+    }
+
+    static_assert(registryIsOrdered(), "ODPedalParameters::registry must be in ParameterIndex order");
+
+    constexpr const ParameterSpec& getSpec(ParameterIndex index)
+    {
+        return registry[static_cast<std::size_t>(index)];
+    }
+
     // parameter IDs
-    constexpr auto DRIVE_ID = "drive";
-    constexpr auto TONE_ID  = "tone";
-    constexpr auto LEVEL_ID = "level";
-    constexpr auto BYPASS_ID = "bypass";
+    constexpr auto DRIVE_ID = getSpec(ParameterIndex::Drive).id;
+    constexpr auto TONE_ID  = getSpec(ParameterIndex::Tone).id;
+    constexpr auto LEVEL_ID = getSpec(ParameterIndex::Level).id;
+    constexpr auto BYPASS_ID = getSpec(ParameterIndex::Bypass).id;
+    constexpr auto CABINET_ID = getSpec(ParameterIndex::Cabinet).id;
+    constexpr auto TOUCH_ID = getSpec(ParameterIndex::Touch).id;
 
     // parameter names
-    constexpr auto DRIVE_NAME = "Drive";
-    constexpr auto TONE_NAME  = "Tone";
-    constexpr auto LEVEL_NAME = "Level";
-    constexpr auto BYPASS_NAME = "Bypass";
+    constexpr auto DRIVE_NAME = getSpec(ParameterIndex::Drive).name;
+    constexpr auto TONE_NAME  = getSpec(ParameterIndex::Tone).name;
+    constexpr auto LEVEL_NAME = getSpec(ParameterIndex::Level).name;
+    constexpr auto BYPASS_NAME = getSpec(ParameterIndex::Bypass).name;
+    constexpr auto CABINET_NAME = getSpec(ParameterIndex::Cabinet).name;
+    constexpr auto TOUCH_NAME = getSpec(ParameterIndex::Touch).name;
 
-    // APTVS layout
+    // normalisable range of a registry entry
+    juce::NormalisableRange<float> makeRange(const ParameterSpec& spec);
+
+    // APTVS layout, generated from the registry
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+
+    // raw value pointers resolved once, so the audio thread reads parameters
+    // by index without any string hashing or map lookups
+    class ParameterHandles
+    {
+        public:
+            // look up every registry entry, call once the APVTS exists
+            void resolve(juce::AudioProcessorValueTreeState& apvts);
+
+            float get(ParameterIndex index) const
+            {
+                return values[static_cast<std::size_t>(index)]->load(std::memory_order_relaxed);
+            }
+
+            bool getBool(ParameterIndex index) const
+            {
+                return get(index) > 0.5f;
+            }
+
+            // set a plain (denormalised) value and tell the host. any thread but the
+            // audio thread: setStateInformation may run wherever the host calls it,
+            // the value itself is atomic and JUCE forwards the change to the host and
+            // the editor's attachments from the calling thread. unchanged values are
+            // skipped, so restoring a session only notifies for what moved
+            void set(ParameterIndex index, float value);
+
+        private:
+            std::array<std::atomic<float>*, numParameters> values {};
+            std::array<juce::RangedAudioParameter*, numParameters> objects {};
+    };
 }
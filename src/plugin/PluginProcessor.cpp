@@ -1,83 +1,290 @@
+# include <juce_audio_formats/juce_audio_formats.h>
 # include "PluginProcessor.h"
 # include "PluginEditor.h"
+# include "PluginState.h"
 
 PluginProcessor::PluginProcessor()
     : juce::AudioProcessor (juce::AudioProcessor::BusesProperties()
                                 .withInput  ("Input",  juce::AudioChannelSet::mono(), true)
                                 .withOutput ("Output", juce::AudioChannelSet::mono(), true)
                             ),
-    apvts (*this, nullptr, "OD_PEDAL", createLayout())
+    apvts (*this, nullptr, "OD_PEDAL", createLayout()),
+    programBank (floatChain.get<OverdriveDSP<float>>(), doubleChain.get<OverdriveDSP<double>>())
 {
+    // resolve parameter pointers once so processBlock never looks them up by name
+    parameters.resolve(apvts);
+
+    // programs selected from the audio thread reach the parameters through here
+    startTimer(PROGRAM_SYNC_INTERVAL_MS);
+
+# if defined(ODPEDAL_ENABLE_TRACING) && ODPEDAL_ENABLE_TRACING
+    // tracing builds record a timeline to ODPEDAL_TRACE_FILE, the first instance starts it
+    if (const char* tracePath = std::getenv("ODPEDAL_TRACE_FILE"))
+        TraceRecorder::getInstance().start(tracePath);
+# endif
+}
+
+PluginProcessor::~PluginProcessor()
+{
+    // the program sync reads programBank and parameters, stop it before they go
+    stopTimer();
 }
 
 void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    dsp.prepare(static_cast<float>(sampleRate));
+    juce::ignoreUnused(samplesPerBlock);
+
+    // one filter state per channel, processed together in SIMD lanes; a mono
+    // channel runs its filters in look-ahead form instead. both precisions are
+    // prepared so a later precision switch finds a ready chain, and the cabinet
+    // allocates every FFT buffer for this rate here
+    int numChannels = juce::jmax(1, getTotalNumInputChannels(), getTotalNumOutputChannels());
+    floatChain.get<OverdriveDSP<float>>().setFilterStructure(FilterStructure::LookAhead);
+    doubleChain.get<OverdriveDSP<double>>().setFilterStructure(FilterStructure::LookAhead);
+    floatChain.prepare(static_cast<float>(sampleRate), juce::jmax(1, getTotalNumOutputChannels()));
+    doubleChain.prepare(static_cast<float>(sampleRate), juce::jmax(1, getTotalNumOutputChannels()));
+    floatSubBlock.assign((size_t)numChannels, nullptr);
+    doubleSubBlock.assign((size_t)numChannels, nullptr);
+
+    // program snapshots hold tone coefficients for this rate
+    programBank.prepare();
+
+    // block budgets are relative to this rate
+    telemetry.prepare(sampleRate);
+    meterFeed.setSampleRate(sampleRate);
 }
 
 void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     // no midi
     juce::ignoreUnused(midiMessages);
+    processSamples(buffer, floatChain, floatSubBlock);
+}
 
-    // get pointer to audio data
-    float* outputChannelPtr = buffer.getWritePointer(0);
+void PluginProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    // no midi
+    juce::ignoreUnused(midiMessages);
+    processSamples(buffer, doubleChain, doubleSubBlock);
+}
+
+bool PluginProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
+template <typename Sample>
+void PluginProcessor::processSamples(juce::AudioBuffer<Sample>& buffer, Chain<Sample>& chain, std::vector<Sample*>& subBlockChannels)
+{
+    // get pointers to audio data
+    Sample* const* channelPtrs = buffer.getArrayOfWritePointers();
+    int numChannels = juce::jmin(getTotalNumInputChannels(), buffer.getNumChannels());
     int numSamples = buffer.getNumSamples();
 
-    // read bypass parameter
-    bool isBypassed = apvts.getRawParameterValue(ODPedalParameters::BYPASS_ID)->load() > 0.5f;
-    if (isBypassed)
-        return;
+    // time the whole block, including the bypass path
+    PerformanceTelemetry::ScopedBlock blockTimer(telemetry, numSamples);
+    ODPEDAL_TRACE_SCOPE("processBlock");
+    ODPEDAL_REALTIME_SCOPE("PluginProcessor::processBlock");
+
+    // clear any output channels without a matching input
+    for (int channel = numChannels; channel < getTotalNumOutputChannels(); ++channel)
+        buffer.clear(channel, 0, numSamples);
 
-    // read params
-    float drive = apvts.getRawParameterValue(ODPedalParameters::DRIVE_ID)->load();
-    float tone = apvts.getRawParameterValue(ODPedalParameters::TONE_ID)->load();
-    float level = apvts.getRawParameterValue(ODPedalParameters::LEVEL_ID)->load();
+    using ODPedalParameters::ParameterIndex;
 
-    // call dsp process
-    dsp.process(outputChannelPtr, numSamples, drive, tone, level);
+    // read bypass parameter, bypass passes the input through untouched
+    bool isBypassed = parameters.getBool(ParameterIndex::Bypass);
+
+    // the cabinet would otherwise replay the audio from before the bypass
+    auto& overdrive = chain.template get<OverdriveDSP<Sample>>();
+    auto& cabinet = chain.template get<CabinetSim<Sample>>();
+    if (wasBypassed && !isBypassed)
+        cabinet.reset();
+    wasBypassed = isBypassed;
+
+    // a program selected since the last block switches in here: its coefficients
+    // come precomputed and the overdrive crossfades from the previous sound. a
+    // selection stays pending while bypassed, and both precisions take it so a
+    // later precision switch does not bring back the previous program
+    const auto* program = isBypassed ? nullptr : programBank.takeSelection();
+    if (program != nullptr)
+    {
+        floatChain.get<OverdriveDSP<float>>().applySnapshot(program->floatSnapshot);
+        doubleChain.get<OverdriveDSP<double>>().applySnapshot(program->doubleSnapshot);
+        programHold.begin(program->values, parameters);
+    }
+
+    // long host blocks run as cache-sized sub-blocks: metering and the chain
+    // touch each one while it is still in L1, and drive/tone/level are re-read
+    // at every boundary so changes land within a sub-block of their arrival
+    numChannels = juce::jmin(numChannels, (int)subBlockChannels.size());
+    const bool metering = meterFeed.isAttached();
+    MeterFeed::Levels levels;
+    float inputSquares = 0.0f;
+    float outputSquares = 0.0f;
+
+    for (int start = 0; start < numSamples; start += SUB_BLOCK_SIZE)
+    {
+        int length = juce::jmin(SUB_BLOCK_SIZE, numSamples - start);
+        for (int channel = 0; channel < numChannels; ++channel)
+            subBlockChannels[(size_t)channel] = channelPtrs[channel] + start;
+
+        ODPEDAL_TRACE_SCOPE("sub_block");
+
+        // input levels before processing, only measured while an editor shows them
+        float peak, rms;
+        if (metering)
+        {
+            MeterFeed::measure(subBlockChannels.data(), numChannels, length, peak, rms);
+            levels.inputPeak = juce::jmax(levels.inputPeak, peak);
+            inputSquares += rms * rms * (float)length;
+        }
+
+        if (!isBypassed)
+        {
+            // read params, a new program's values until the parameters follow it
+            float drive = programHold.get(ParameterIndex::Drive, parameters);
+            float tone = programHold.get(ParameterIndex::Tone, parameters);
+            float level = programHold.get(ParameterIndex::Level, parameters);
+
+            // run the chain, ramps start at this sub-block
+            overdrive.setParameters(drive, tone, level);
+            const bool touch = programHold.getBool(ParameterIndex::Touch, parameters);
+            overdrive.setEnvelopeModulation(touch ? TOUCH_DRIVE_DEPTH_DB : 0.0f, touch ? TOUCH_TONE_DEPTH_OCTAVES : 0.0f);
+            cabinet.setEnabled(programHold.getBool(ParameterIndex::Cabinet, parameters));
+            chain.processBlock(subBlockChannels.data(), numChannels, length);
+            levels.clipperPeak = juce::jmax(levels.clipperPeak, overdrive.getClipperPeak());
+        }
+
+        // output levels
+        if (metering)
+        {
+            MeterFeed::measure(subBlockChannels.data(), numChannels, length, peak, rms);
+            levels.outputPeak = juce::jmax(levels.outputPeak, peak);
+            outputSquares += rms * rms * (float)length;
+        }
+    }
+
+    // one reading per host block, and the first channel for the spectrum. with
+    // no editor open nothing would drain them, and a later editor would start
+    // from a full queue of stale readings
+    if (metering && numChannels > 0 && numSamples > 0)
+    {
+        levels.inputRms = std::sqrt(inputSquares / (float)numSamples);
+        levels.outputRms = std::sqrt(outputSquares / (float)numSamples);
+        meterFeed.push(levels, channelPtrs[0], numSamples);
+    }
 }
 
 void PluginProcessor::releaseResources()
 {
-    dsp.reset();
+    floatChain.reset();
+    doubleChain.reset();
 }
 
 int PluginProcessor::getNumPrograms()
 {
-    return 1;
+    return ODPedalPrograms::numPrograms;
 }
 
 void PluginProcessor::setCurrentProgram(int index)
 {
-    juce::ignoreUnused(index);
+    if (index < 0 || index >= ODPedalPrograms::numPrograms)
+        return;
+
+    // the sound switches at the audio thread's next block whichever thread this is
+    programBank.select(index);
+
+    // hosts may change programs from the audio thread, which must not notify
+    // parameter listeners; the timer writes the parameters for those
+    if (juce::MessageManager::existsAndIsCurrentThread())
+        applyProgramToParameters(index);
+    else
+        programNeedsParameters.store(true, std::memory_order_release);
 }
 
 int PluginProcessor::getCurrentProgram()
 {
-    return 0;
+    return programBank.getCurrent();
 }
 
 const juce::String PluginProcessor::getProgramName(int index)
 {
-    juce::ignoreUnused(index);
-    return "Default";
+    return programBank.getName(index);
 }
 
 void PluginProcessor::changeProgramName(int index, const juce::String& newName)
 {
-    juce::ignoreUnused(index, newName);
+    // factory programs keep their names
+    if (!ODPedalPrograms::isUserProgram(index))
+        return;
+
+    programBank.setName(index, newName);
+    updateHostDisplay(juce::AudioProcessor::ChangeDetails().withProgramChanged(true));
+    sendChangeMessage();
+}
+
+void PluginProcessor::storeUserProgram(int index)
+{
+    if (!ODPedalPrograms::isUserProgram(index))
+        return;
+
+    ODPedalPrograms::Values values {};
+    for (const auto& spec : ODPedalParameters::registry)
+        values[(size_t)spec.index] = parameters.get(spec.index);
+
+    // the stored values are what is playing, so only the current index moves
+    programBank.store(index, values);
+    programBank.setCurrent(index);
+    updateHostDisplay(juce::AudioProcessor::ChangeDetails().withProgramChanged(true));
+    sendChangeMessage();
+}
+
+void PluginProcessor::applyProgramToParameters(int index)
+{
+    const ODPedalPrograms::Values values = programBank.getValues(index);
+    for (const auto& spec : ODPedalParameters::registry)
+    {
+        if (spec.inPrograms)
+            parameters.set(spec.index, values[(size_t)spec.index]);
+    }
+
+    updateHostDisplay(juce::AudioProcessor::ChangeDetails().withProgramChanged(true));
+    sendChangeMessage();
+}
+
+void PluginProcessor::timerCallback()
+{
+    if (programNeedsParameters.exchange(false, std::memory_order_acquire))
+        applyProgramToParameters(programBank.getCurrent());
 }
 
 void PluginProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    // compact binary encoding, see PluginState.h
+    ODPedalState::write(parameters, getCabinetImpulsePath(), programBank, destData);
 }
 
 void PluginProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+    // binary state is applied straight to the parameters, no XML or ValueTree involved
+    if (ODPedalState::isBinaryState(data, sizeInBytes))
+    {
+        juce::String impulsePath;
+        if (!ODPedalState::read(data, sizeInBytes, parameters, impulsePath, programBank))
+            return;
+
+        // a missing file keeps whatever impulse is loaded now
+        if (impulsePath.isNotEmpty() && impulsePath != getCabinetImpulsePath())
+            loadCabinetImpulse(juce::File(impulsePath));
+
+        // restored user programs and the current program's name
+        updateHostDisplay(juce::AudioProcessor::ChangeDetails().withProgramChanged(true));
+        sendChangeMessage();
+        return;
+    }
+
+    // legacy sessions saved the APVTS state as XML
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
     if (xmlState != nullptr && xmlState->hasTagName(apvts.state.getType()))
     {
@@ -107,12 +314,14 @@ bool PluginProcessor::isMidiEffect() const
 
 bool PluginProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 {
-    // only support mono in/out
+    // any channel count, as long as input and output match
     if (layouts.inputBuses.size() != 1 || layouts.outputBuses.size() != 1)
         return false;
-    
-    return layouts.getMainInputChannelSet() == juce::AudioChannelSet::mono()
-        && layouts.getMainOutputChannelSet() == juce::AudioChannelSet::mono();
+
+    const auto& inputSet = layouts.getMainInputChannelSet();
+    const auto& outputSet = layouts.getMainOutputChannelSet();
+
+    return !outputSet.isDisabled() && inputSet == outputSet;
 }
 
 bool PluginProcessor::hasEditor() const
@@ -127,7 +336,50 @@ juce::AudioProcessorEditor* PluginProcessor::createEditor()
 
 double PluginProcessor::getTailLengthSeconds() const
 {
-    return 0.0; // no reverb tail
+    // the cabinet rings for as long as its impulse, the overdrive has no tail
+    if (!parameters.getBool(ODPedalParameters::ParameterIndex::Cabinet))
+        return 0.0;
+
+    return floatChain.get<CabinetSim<float>>().getImpulseSeconds();
+}
+
+bool PluginProcessor::loadCabinetImpulse(const juce::File& file)
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr || reader->lengthInSamples <= 0 || reader->sampleRate <= 0.0)
+        return false;
+
+    // the stage keeps at most maxImpulseSeconds, so longer files are not read in full
+    const auto maxSamples = (juce::int64)std::ceil(CabinetSim<float>::maxImpulseSeconds * reader->sampleRate);
+    const int numSamples = (int)juce::jmin(reader->lengthInSamples, maxSamples);
+    const int numChannels = juce::jmax(1, (int)reader->numChannels);
+
+    juce::AudioBuffer<float> fileBuffer(numChannels, numSamples);
+    reader->read(&fileBuffer, 0, numSamples, 0, true, true);
+
+    std::vector<float> impulse((size_t)numSamples, 0.0f);
+    for (int channel = 0; channel < numChannels; ++channel)
+        juce::FloatVectorOperations::addWithMultiply(impulse.data(), fileBuffer.getReadPointer(channel),
+                                                     1.0f / (float)numChannels, numSamples);
+
+    // resampling and partitioning happen here, the audio thread only swaps pointers
+    const float impulseRate = (float)reader->sampleRate;
+    if (!floatChain.get<CabinetSim<float>>().loadImpulse(impulse.data(), numSamples, impulseRate))
+        return false;
+    doubleChain.get<CabinetSim<double>>().loadImpulse(impulse.data(), numSamples, impulseRate);
+
+    std::lock_guard<std::mutex> lock(cabinetPathMutex);
+    cabinetImpulsePath = file.getFullPathName();
+    return true;
+}
+
+juce::String PluginProcessor::getCabinetImpulsePath() const
+{
+    std::lock_guard<std::mutex> lock(cabinetPathMutex);
+    return cabinetImpulsePath;
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createLayout()
@@ -1,13 +1,21 @@
 # pragma once
 
+# include <mutex>
 # include <juce_audio_processors/juce_audio_processors.h>
+# include "../dsp/CabinetSim.h"
 # include "../dsp/OverdriveDSP.h"
+# include "../dsp/PedalChain.h"
+# include "../dsp/PerformanceTelemetry.h"
+# include "../dsp/RealtimeCheck.h"
+# include "../dsp/TraceRecorder.h"
 # include "PluginParameters.h"
+# include "MeterFeed.h"
+# include "ProgramBank.h"
 
 // forward declaration
 class PluginEditor;
 
-class PluginProcessor : public juce::AudioProcessor
+class PluginProcessor : public juce::AudioProcessor, public juce::ChangeBroadcaster, private juce::Timer
 {
     public:
         // params
@@ -15,18 +23,23 @@ class PluginProcessor : public juce::AudioProcessor
 
         // constructor and destructor
         PluginProcessor();
-        ~PluginProcessor() override = default;
+        ~PluginProcessor() override;
 
         // called before playback starts
         void prepareToPlay(double sampleRate, int samplesPerBlock) override;
         
-        // called repeatedly during playback
+        // called repeatedly during playback, in the precision the host selected
         void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override;
+        void processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages) override;
+
+        // 64-bit hosts hand us their buffers directly instead of converting
+        bool supportsDoublePrecisionProcessing() const override;
     
         // called when playback stops
         void releaseResources() override;
 
-        // program overrides for presets
+        // program overrides, backed by the factory and user programs in
+        // ProgramBank.h; setCurrentProgram() is lock-free from any thread
         int getNumPrograms() override;
         void setCurrentProgram(int index) override;
         int getCurrentProgram() override;
@@ -53,9 +66,82 @@ class PluginProcessor : public juce::AudioProcessor
         // tail
         double getTailLengthSeconds() const override;
 
+        // processBlock timing, safe to read from any thread
+        PerformanceTelemetry& getTelemetry() { return telemetry; }
+
+        // levels and output samples for the editor's meters
+        MeterFeed& getMeterFeed() { return meterFeed; }
+
+        // read an audio file as the cabinet impulse (channels averaged to mono)
+        // and hand it to both chains, any thread but the audio thread. false if
+        // it cannot be read
+        bool loadCabinetImpulse(const juce::File& file);
+
+        // file the current impulse came from, empty when none is loaded, any thread
+        juce::String getCabinetImpulsePath() const;
+
+        // save the current parameter values as a user program and select it,
+        // message thread. editors are told through the change broadcaster
+        void storeUserProgram(int index);
+
     private:
-        // DSP instance
-        OverdriveDSP dsp;
+        // DSP chain, composed at compile time; new stages are appended here
+        template <typename Sample>
+        using Chain = PedalChain<OverdriveDSP<Sample>, CabinetSim<Sample>>;
+
+        // one chain per precision, only the host's choice runs
+        Chain<float> floatChain;
+        Chain<double> doubleChain;
+
+        // processBlock works through the host buffer in sub-blocks of this many
+        // samples, the DSP's own chunk size (2 KB per stereo sub-block)
+        static constexpr int SUB_BLOCK_SIZE = 256;
+
+        // touch-sensitive mode depths at full envelope, drive in dB and tone in octaves
+        static constexpr float TOUCH_DRIVE_DEPTH_DB = 9.0f;
+        static constexpr float TOUCH_TONE_DEPTH_OCTAVES = 1.0f;
+
+        // channel pointers into the current sub-block, sized in prepareToPlay
+        std::vector<float*> floatSubBlock;
+        std::vector<double*> doubleSubBlock;
+
+        // audio thread timing, written once per block
+        PerformanceTelemetry telemetry;
+
+        // lock-free hand-off of meter data to the editor
+        MeterFeed meterFeed;
+
+        // cached parameter values, resolved once in the constructor
+        ODPedalParameters::ParameterHandles parameters;
+
+        // bypass state of the previous block, the cabinet restarts clean after a bypass
+        bool wasBypassed = false;
+
+        // programs with their precomputed snapshots, after the chains they were built for
+        ODPedalPrograms::ProgramBank programBank;
+
+        // audio thread: keeps a freshly applied program until the parameters catch up
+        ODPedalPrograms::ProgramHold programHold;
+
+        // a program selected off the message thread, its values still have to be
+        // written to the parameters; the timer picks it up
+        std::atomic<bool> programNeedsParameters { false };
+        static constexpr int PROGRAM_SYNC_INTERVAL_MS = 50;
+
+        // saved with the session and reloaded from disk. hosts may save and restore
+        // state off the message thread, so it is guarded by cabinetPathMutex
+        juce::String cabinetImpulsePath;
+        mutable std::mutex cabinetPathMutex;
+
+        // shared body of both processBlock overloads
+        template <typename Sample>
+        void processSamples(juce::AudioBuffer<Sample>& buffer, Chain<Sample>& chain, std::vector<Sample*>& subBlockChannels);
+
+        // write a program's values to the parameters and tell the host, message thread
+        void applyProgramToParameters(int index);
+
+        // message thread half of a program selected elsewhere
+        void timerCallback() override;
 
         // helper to update cached params
         juce::AudioProcessorValueTreeState::ParameterLayout createLayout();
@@ -0,0 +1,268 @@
+# include "PluginState.h"
+
+# include <array>
+# include <cmath>
+# include <cstring>
+
+namespace
+{
+    constexpr int HEADER_SIZE = 8;
+
+    void writeU16(std::uint8_t* p, std::uint16_t value)
+    {
+        p[0] = static_cast<std::uint8_t>(value & 0xff);
+        p[1] = static_cast<std::uint8_t>(value >> 8);
+    }
+
+    std::uint16_t readU16(const std::uint8_t* p)
+    {
+        return static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+    }
+
+    void writeFloat(std::uint8_t* p, float value)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        for (int i = 0; i < 4; ++i)
+            p[i] = static_cast<std::uint8_t>((bits >> (8 * i)) & 0xff);
+    }
+
+    float readFloat(const std::uint8_t* p)
+    {
+        std::uint32_t bits = static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8)
+                           | (static_cast<std::uint32_t>(p[2]) << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // helper to map a stored id back to the registry, nullptr for unknown ids
+    const ODPedalParameters::ParameterSpec* findSpec(const std::uint8_t* id, int idLength)
+    {
+        for (const auto& spec : ODPedalParameters::registry)
+        {
+            if (static_cast<int>(std::strlen(spec.id)) == idLength && std::memcmp(spec.id, id, static_cast<std::size_t>(idLength)) == 0)
+                return &spec;
+        }
+        return nullptr;
+    }
+
+    // bytes taken by one list of every registry entry
+    std::size_t entryListSize()
+    {
+        std::size_t size = 0;
+        for (const auto& spec : ODPedalParameters::registry)
+            size += 1 + std::strlen(spec.id) + 4;
+        return size;
+    }
+
+    // write one entry per registry entry, returns the position after them
+    std::uint8_t* writeEntries(std::uint8_t* p, const ODPedalPrograms::Values& values)
+    {
+        for (const auto& spec : ODPedalParameters::registry)
+        {
+            const std::size_t idLength = std::strlen(spec.id);
+            *p++ = static_cast<std::uint8_t>(idLength);
+            std::memcpy(p, spec.id, idLength);
+            p += idLength;
+            writeFloat(p, values[static_cast<std::size_t>(spec.index)]);
+            p += 4;
+        }
+        return p;
+    }
+
+    // parse numEntries entries into values, marking each one found. ids this
+    // build does not know are skipped, so newer sessions still load. returns
+    // the position after the entries, nullptr when the data ends early
+    const std::uint8_t* readEntries(const std::uint8_t* p, const std::uint8_t* end, int numEntries,
+                                    ODPedalPrograms::Values& values,
+                                    std::array<bool, ODPedalParameters::numParameters>& found)
+    {
+        for (int entry = 0; entry < numEntries; ++entry)
+        {
+            if (end - p < 1)
+                return nullptr;
+
+            const int idLength = *p++;
+            if (end - p < idLength + 4)
+                return nullptr;
+
+            const std::uint8_t* id = p;
+            const float value = readFloat(p + idLength);
+            p += idLength + 4;
+
+            if (const auto* spec = findSpec(id, idLength))
+            {
+                if (std::isfinite(value))
+                {
+                    values[static_cast<std::size_t>(spec->index)] = juce::jlimit(spec->minValue, spec->maxValue, value);
+                    found[static_cast<std::size_t>(spec->index)] = true;
+                }
+            }
+        }
+        return p;
+    }
+
+    // user program names are stored with a uint8 length, cut at a character boundary
+    juce::String storedName(juce::String name)
+    {
+        while (name.getNumBytesAsUTF8() > 0xff)
+            name = name.dropLastCharacters(1);
+        return name;
+    }
+}
+
+void ODPedalState::write(const ODPedalParameters::ParameterHandles& parameters, const juce::String& cabinetImpulsePath,
+                         const ODPedalPrograms::ProgramBank& programs, juce::MemoryBlock& destData)
+{
+    using ODPedalPrograms::numFactoryPrograms;
+    using ODPedalPrograms::numUserPrograms;
+
+    const char* path = cabinetImpulsePath.toRawUTF8();
+    const std::size_t pathLength = juce::jmin<std::size_t>(std::strlen(path), 0xffff);
+
+    ODPedalPrograms::Values current {};
+    for (const auto& spec : ODPedalParameters::registry)
+        current[static_cast<std::size_t>(spec.index)] = parameters.get(spec.index);
+
+    std::array<juce::String, numUserPrograms> userNames;
+    std::array<ODPedalPrograms::Values, numUserPrograms> userValues;
+    std::size_t programsSize = 2 + 1;
+    for (int i = 0; i < numUserPrograms; ++i)
+    {
+        userNames[static_cast<std::size_t>(i)] = storedName(programs.getName(numFactoryPrograms + i));
+        userValues[static_cast<std::size_t>(i)] = programs.getValues(numFactoryPrograms + i);
+        programsSize += 1 + userNames[static_cast<std::size_t>(i)].getNumBytesAsUTF8() + 2 + entryListSize();
+    }
+
+    destData.setSize(HEADER_SIZE + entryListSize() + 2 + pathLength + programsSize);
+    auto* p = static_cast<std::uint8_t*>(destData.getData());
+
+    std::memcpy(p, MAGIC, sizeof(MAGIC));
+    writeU16(p + 4, FORMAT_VERSION);
+    writeU16(p + 6, static_cast<std::uint16_t>(ODPedalParameters::numParameters));
+    p = writeEntries(p + HEADER_SIZE, current);
+
+    writeU16(p, static_cast<std::uint16_t>(pathLength));
+    std::memcpy(p + 2, path, pathLength);
+    p += 2 + pathLength;
+
+    writeU16(p, static_cast<std::uint16_t>(programs.getCurrent()));
+    p[2] = static_cast<std::uint8_t>(numUserPrograms);
+    p += 3;
+
+    for (int i = 0; i < numUserPrograms; ++i)
+    {
+        const juce::String& name = userNames[static_cast<std::size_t>(i)];
+        const std::size_t nameLength = name.getNumBytesAsUTF8();
+        *p++ = static_cast<std::uint8_t>(nameLength);
+        std::memcpy(p, name.toRawUTF8(), nameLength);
+        p += nameLength;
+
+        writeU16(p, static_cast<std::uint16_t>(ODPedalParameters::numParameters));
+        p = writeEntries(p + 2, userValues[static_cast<std::size_t>(i)]);
+    }
+}
+
+bool ODPedalState::isBinaryState(const void* data, int sizeInBytes)
+{
+    return data != nullptr && sizeInBytes >= HEADER_SIZE && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+bool ODPedalState::read(const void* data, int sizeInBytes, ODPedalParameters::ParameterHandles& parameters,
+                        juce::String& cabinetImpulsePath, ODPedalPrograms::ProgramBank& programs)
+{
+    using ODPedalPrograms::numFactoryPrograms;
+    using ODPedalPrograms::numUserPrograms;
+
+    if (!isBinaryState(data, sizeInBytes))
+        return false;
+
+    const auto* p = static_cast<const std::uint8_t*>(data);
+    const auto* end = p + sizeInBytes;
+
+    // the entry table layout is fixed for every version, later data is appended after it
+    const std::uint16_t version = readU16(p + 4);
+    const int numEntries = readU16(p + 6);
+    if (version < 1)
+        return false;
+
+    // parse everything first so truncated data leaves the parameters untouched
+    ODPedalPrograms::Values values {};
+    std::array<bool, ODPedalParameters::numParameters> found {};
+
+    p = readEntries(p + HEADER_SIZE, end, numEntries, values, found);
+    if (p == nullptr)
+        return false;
+
+    // version 2 trailer, a path cut short is ignored rather than failing the whole state
+    cabinetImpulsePath = {};
+    bool pathComplete = false;
+    if (version >= 2 && end - p >= 2)
+    {
+        const int pathLength = readU16(p);
+        if (end - p - 2 >= pathLength)
+        {
+            cabinetImpulsePath = juce::String::fromUTF8(reinterpret_cast<const char*>(p + 2), pathLength);
+            p += 2 + pathLength;
+            pathComplete = true;
+        }
+    }
+
+    // version 3 programs, likewise only the complete ones are restored
+    int currentProgram = -1;
+    int numStoredPrograms = 0;
+    std::array<juce::String, numUserPrograms> userNames;
+    std::array<ODPedalPrograms::Values, numUserPrograms> userValues;
+
+    if (version >= 3 && pathComplete && end - p >= 3)
+    {
+        currentProgram = readU16(p);
+        const int storedPrograms = p[2];
+        p += 3;
+
+        for (int i = 0; i < storedPrograms && i < numUserPrograms; ++i)
+        {
+            if (end - p < 1)
+                break;
+
+            const int nameLength = *p++;
+            if (end - p < nameLength + 2)
+                break;
+
+            const juce::String name = juce::String::fromUTF8(reinterpret_cast<const char*>(p), nameLength);
+            const int programEntries = readU16(p + nameLength);
+
+            // entries missing from older sessions keep the slot's current values
+            ODPedalPrograms::Values programValues = programs.getValues(numFactoryPrograms + i);
+            std::array<bool, ODPedalParameters::numParameters> programFound {};
+            p = readEntries(p + nameLength + 2, end, programEntries, programValues, programFound);
+            if (p == nullptr)
+                break;
+
+            userNames[static_cast<std::size_t>(i)] = name;
+            userValues[static_cast<std::size_t>(i)] = programValues;
+            numStoredPrograms = i + 1;
+        }
+    }
+
+    // parameters missing from older sessions take their defaults, so a session
+    // restores the same sound into a fresh instance and one already in use
+    for (const auto& spec : ODPedalParameters::registry)
+    {
+        const std::size_t i = static_cast<std::size_t>(spec.index);
+        parameters.set(spec.index, found[i] ? values[i] : spec.defaultValue);
+    }
+
+    for (int i = 0; i < numStoredPrograms; ++i)
+    {
+        programs.setName(numFactoryPrograms + i, userNames[static_cast<std::size_t>(i)]);
+        programs.store(numFactoryPrograms + i, userValues[static_cast<std::size_t>(i)]);
+    }
+
+    // the parameters already hold the session's sound, so this only marks the program
+    if (currentProgram >= 0)
+        programs.setCurrent(currentProgram);
+
+    return true;
+}
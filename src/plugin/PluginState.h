@@ -0,0 +1,40 @@
+# pragma once
+
+# include <juce_audio_processors/juce_audio_processors.h>
+# include "PluginParameters.h"
+# include "ProgramBank.h"
+
+// compact binary plugin state.
+//
+//   offset 0   magic "ODPS"
+//   offset 4   uint16 format version
+//   offset 6   uint16 entry count
+//   offset 8   entries: uint8 id length, id bytes, float32 plain value
+//   version 2  then uint16 byte length and the UTF-8 path of the cabinet
+//              impulse file, length 0 when none is loaded
+//   version 3  then uint16 current program, uint8 user program count, and per
+//              user program: uint8 name length, UTF-8 name, uint16 entry count
+//              and entries laid out like the ones above
+//
+// all integers and floats are little-endian. entries are keyed by parameter id,
+// so parameters added later are missing from older states and load with their
+// defaults, and removed ones are skipped.
+// newer versions may append data after the entry list, which older readers ignore.
+namespace ODPedalState
+{
+    constexpr char MAGIC[4] = { 'O', 'D', 'P', 'S' };
+    constexpr std::uint16_t FORMAT_VERSION = 3;
+
+    // encode the current parameter values, the cabinet impulse path and the programs
+    void write(const ODPedalParameters::ParameterHandles& parameters, const juce::String& cabinetImpulsePath,
+               const ODPedalPrograms::ProgramBank& programs, juce::MemoryBlock& destData);
+
+    // true when the data starts with the binary state magic
+    bool isBinaryState(const void* data, int sizeInBytes);
+
+    // apply the stored values and user programs and return the stored impulse
+    // path (empty before version 2), returns false on malformed data. runs on
+    // whichever thread the host restores state from, see ParameterHandles::set
+    bool read(const void* data, int sizeInBytes, ODPedalParameters::ParameterHandles& parameters,
+              juce::String& cabinetImpulsePath, ODPedalPrograms::ProgramBank& programs);
+}
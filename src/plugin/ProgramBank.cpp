@@ -0,0 +1,199 @@
+# include "ProgramBank.h"
+
+namespace
+{
+    using ODPedalParameters::ParameterIndex;
+
+    // the value a parameter ends up holding when set to value, so a program's
+    // snapshot matches the ramp targets the audio thread reads afterwards
+    float quantise(const ODPedalParameters::ParameterSpec& spec, float value)
+    {
+        if (spec.isToggle)
+            return value > 0.5f ? 1.0f : 0.0f;
+
+        const auto range = ODPedalParameters::makeRange(spec);
+        return range.convertFrom0to1(range.convertTo0to1(value));
+    }
+
+    ODPedalPrograms::Values defaultValues()
+    {
+        ODPedalPrograms::Values result {};
+        for (const auto& spec : ODPedalParameters::registry)
+            result[static_cast<std::size_t>(spec.index)] = quantise(spec, spec.defaultValue);
+        return result;
+    }
+
+    ODPedalPrograms::Values factoryValues(const ODPedalPrograms::FactoryProgram& program)
+    {
+        ODPedalPrograms::Values result = defaultValues();
+        auto set = [&result](ParameterIndex index, float value)
+        {
+            result[static_cast<std::size_t>(index)] = quantise(ODPedalParameters::getSpec(index), value);
+        };
+
+        set(ParameterIndex::Drive, program.drive);
+        set(ParameterIndex::Tone, program.tone);
+        set(ParameterIndex::Level, program.level);
+        set(ParameterIndex::Cabinet, program.cabinet ? 1.0f : 0.0f);
+        set(ParameterIndex::Touch, program.touch ? 1.0f : 0.0f);
+        return result;
+    }
+}
+
+ODPedalPrograms::ProgramBank::ProgramBank(const OverdriveDSP<float>& floatOverdriveRef,
+                                          const OverdriveDSP<double>& doubleOverdriveRef)
+    : floatOverdrive(floatOverdriveRef), doubleOverdrive(doubleOverdriveRef)
+{
+    for (int i = 0; i < numFactoryPrograms; ++i)
+    {
+        names[static_cast<std::size_t>(i)] = factoryPrograms[static_cast<std::size_t>(i)].name;
+        values[static_cast<std::size_t>(i)] = factoryValues(factoryPrograms[static_cast<std::size_t>(i)]);
+    }
+
+    for (int i = numFactoryPrograms; i < numPrograms; ++i)
+    {
+        names[static_cast<std::size_t>(i)] = "User " + juce::String(i - numFactoryPrograms + 1);
+        values[static_cast<std::size_t>(i)] = defaultValues();
+    }
+
+    std::lock_guard<std::mutex> lock(bankMutex);
+    rebuild();
+}
+
+ODPedalPrograms::ProgramBank::~ProgramBank()
+{
+    delete active;
+    delete pending.load();
+    delete retired.load();
+}
+
+void ODPedalPrograms::ProgramBank::prepare()
+{
+    std::lock_guard<std::mutex> lock(bankMutex);
+    rebuild();
+}
+
+juce::String ODPedalPrograms::ProgramBank::getName(int index) const
+{
+    if (index < 0 || index >= numPrograms)
+        return {};
+
+    std::lock_guard<std::mutex> lock(bankMutex);
+    return names[static_cast<std::size_t>(index)];
+}
+
+ODPedalPrograms::Values ODPedalPrograms::ProgramBank::getValues(int index) const
+{
+    std::lock_guard<std::mutex> lock(bankMutex);
+    return values[static_cast<std::size_t>(juce::jlimit(0, numPrograms - 1, index))];
+}
+
+void ODPedalPrograms::ProgramBank::setName(int index, const juce::String& name)
+{
+    if (!isUserProgram(index))
+        return;
+
+    std::lock_guard<std::mutex> lock(bankMutex);
+    names[static_cast<std::size_t>(index)] = name;
+}
+
+void ODPedalPrograms::ProgramBank::store(int index, const Values& newValues)
+{
+    if (!isUserProgram(index))
+        return;
+
+    std::lock_guard<std::mutex> lock(bankMutex);
+    for (const auto& spec : ODPedalParameters::registry)
+    {
+        const auto i = static_cast<std::size_t>(spec.index);
+        values[static_cast<std::size_t>(index)][i] = quantise(spec, juce::jlimit(spec.minValue, spec.maxValue, newValues[i]));
+    }
+
+    rebuild();
+}
+
+void ODPedalPrograms::ProgramBank::select(int index)
+{
+    if (index < 0 || index >= numPrograms)
+        return;
+
+    current.store(index, std::memory_order_relaxed);
+    requested.store(index, std::memory_order_release);
+}
+
+void ODPedalPrograms::ProgramBank::setCurrent(int index)
+{
+    if (index >= 0 && index < numPrograms)
+        current.store(index, std::memory_order_relaxed);
+}
+
+const ODPedalPrograms::ProgramBank::Entry* ODPedalPrograms::ProgramBank::takeSelection()
+{
+    // the request is read first: a table rebuilt before the program was
+    // selected is then already visible to adoptPendingTable()
+    const int index = requested.exchange(-1, std::memory_order_acquire);
+    adoptPendingTable();
+
+    if (index < 0 || active == nullptr)
+        return nullptr;
+
+    return &active->entries[static_cast<std::size_t>(index)];
+}
+
+// snapshots are designed here, off the audio thread, for the prepared rate
+void ODPedalPrograms::ProgramBank::rebuild()
+{
+    auto* next = new Table;
+    for (int i = 0; i < numPrograms; ++i)
+    {
+        Entry& entry = next->entries[static_cast<std::size_t>(i)];
+        entry.values = values[static_cast<std::size_t>(i)];
+
+        const float drive = entry.values[static_cast<std::size_t>(ParameterIndex::Drive)];
+        const float tone = entry.values[static_cast<std::size_t>(ParameterIndex::Tone)];
+        const float level = entry.values[static_cast<std::size_t>(ParameterIndex::Level)];
+        entry.floatSnapshot = floatOverdrive.makeSnapshot(drive, tone, level);
+        entry.doubleSnapshot = doubleOverdrive.makeSnapshot(drive, tone, level);
+    }
+
+    // replace pending first: anything the audio thread adopted before that point
+    // has already moved its predecessor to retired, which is freed next
+    delete pending.exchange(next, std::memory_order_acq_rel);
+    delete retired.exchange(nullptr, std::memory_order_acquire);
+}
+
+void ODPedalPrograms::ProgramBank::adoptPendingTable()
+{
+    if (pending.load(std::memory_order_relaxed) == nullptr || retired.load(std::memory_order_acquire) != nullptr)
+        return;
+
+    Table* next = pending.exchange(nullptr, std::memory_order_acquire);
+    if (next == nullptr)
+        return;
+
+    retired.store(active, std::memory_order_release);
+    active = next;
+}
+
+void ODPedalPrograms::ProgramHold::begin(const Values& programValues, const ODPedalParameters::ParameterHandles& parameters)
+{
+    for (const auto& spec : ODPedalParameters::registry)
+    {
+        const auto i = static_cast<std::size_t>(spec.index);
+        held[i] = programValues[i];
+        replaced[i] = parameters.get(spec.index);
+        holding[i] = spec.inPrograms;
+    }
+}
+
+float ODPedalPrograms::ProgramHold::get(ODPedalParameters::ParameterIndex index, const ODPedalParameters::ParameterHandles& parameters)
+{
+    const auto i = static_cast<std::size_t>(index);
+    const float value = parameters.get(index);
+
+    // the parameter moved, to the program's value or by the user, from now on it leads
+    if (holding[i] && value != replaced[i])
+        holding[i] = false;
+
+    return holding[i] ? held[i] : value;
+}
@@ -0,0 +1,143 @@
+# pragma once
+
+# include <array>
+# include <atomic>
+# include <mutex>
+# include <juce_audio_processors/juce_audio_processors.h>
+# include "../dsp/OverdriveDSP.h"
+# include "PluginParameters.h"
+
+// factory and user programs behind the host's program API.
+//
+// names and values belong to the message thread. the audio thread sees every
+// program as a table entry with its values and ready-made OverdriveDSP snapshots
+// for both precisions; the table is rebuilt off the audio thread when the sample
+// rate or a user program changes and handed over through atomic pointers, the
+// same way CabinetSim swaps impulses. selecting a program only stores its index,
+// so it is lock-free from any thread, and the audio thread applies the entry at
+// the start of its next block.
+namespace ODPedalPrograms
+{
+    // one value per registry entry, only the inPrograms entries are used
+    using Values = std::array<float, ODPedalParameters::numParameters>;
+
+    struct FactoryProgram
+    {
+        const char* name;
+        float drive;     // dB
+        float tone;      // Hz
+        float level;     // dB
+        bool cabinet;
+        bool touch;
+    };
+
+    // read-only programs first, then the user slots
+    constexpr std::array<FactoryProgram, 8> factoryPrograms { {
+        { "Default",         0.0f,  3000.0f,  0.0f, false, false },
+        { "Clean Boost",     2.0f,  5000.0f,  6.0f, false, false },
+        { "Edge of Breakup", 8.0f,  3200.0f,  2.0f, false, true },
+        { "Classic Crunch",  14.0f, 2800.0f,  0.0f, false, false },
+        { "Dark Blues",      11.0f, 1200.0f,  1.0f, false, true },
+        { "Lead",            20.0f, 2400.0f, -2.0f, false, false },
+        { "Crunch Cab",      14.0f, 2800.0f,  0.0f, true,  false },
+        { "Lead Cab",        20.0f, 2400.0f, -2.0f, true,  false }
+    } };
+
+    constexpr int numFactoryPrograms = static_cast<int>(factoryPrograms.size());
+    constexpr int numUserPrograms = 8;
+    constexpr int numPrograms = numFactoryPrograms + numUserPrograms;
+
+    constexpr bool isUserProgram(int index)
+    {
+        return index >= numFactoryPrograms && index < numPrograms;
+    }
+
+    class ProgramBank
+    {
+        public:
+            // what the audio thread needs to switch to a program
+            struct Entry
+            {
+                Values values {};
+                OverdriveDSP<float>::Snapshot floatSnapshot;
+                OverdriveDSP<double>::Snapshot doubleSnapshot;
+            };
+
+            // snapshots are built for the sample rate these stages were prepared at
+            ProgramBank(const OverdriveDSP<float>& floatOverdrive, const OverdriveDSP<double>& doubleOverdrive);
+            ~ProgramBank();
+
+            // rebuild every snapshot after the stages were prepared, message thread
+            void prepare();
+
+            // names and values, message thread
+            juce::String getName(int index) const;
+            Values getValues(int index) const;
+
+            // rename or overwrite a user program, factory programs stay as they are
+            void setName(int index, const juce::String& name);
+            void store(int index, const Values& values);
+
+            // select a program, any thread, lock-free
+            void select(int index);
+
+            // mark a program current without switching the sound, for restored sessions
+            void setCurrent(int index);
+            int getCurrent() const { return current.load(std::memory_order_relaxed); }
+
+            // audio thread: the program selected since the last call, or nullptr
+            const Entry* takeSelection();
+
+        private:
+            struct Table
+            {
+                std::array<Entry, numPrograms> entries;
+            };
+
+            const OverdriveDSP<float>& floatOverdrive;
+            const OverdriveDSP<double>& doubleOverdrive;
+
+            // message thread state, guarded by bankMutex since hosts may call
+            // prepareToPlay from another thread
+            mutable std::mutex bankMutex;
+            std::array<juce::String, numPrograms> names;
+            std::array<Values, numPrograms> values {};
+
+            std::atomic<int> current { 0 };
+            std::atomic<int> requested { -1 };
+
+            // rebuilt tables are published in pending, the audio thread swaps one
+            // in and parks the old one in retired, which the next rebuild frees
+            std::atomic<Table*> pending { nullptr };
+            std::atomic<Table*> retired { nullptr };
+            Table* active = nullptr;
+
+            // build a table from values and hand it over, caller holds bankMutex
+            void rebuild();
+
+            // audio thread: adopt a pending table once the previous one was collected
+            void adoptPendingTable();
+    };
+
+    // audio thread: follows a program's values until each parameter moves off the
+    // value it had when the program was applied. the parameters are updated on
+    // the message thread some time after the switch, and reading them in between
+    // would ramp straight back to the old sound
+    class ProgramHold
+    {
+        public:
+            void begin(const Values& programValues, const ODPedalParameters::ParameterHandles& parameters);
+
+            float get(ODPedalParameters::ParameterIndex index, const ODPedalParameters::ParameterHandles& parameters);
+
+            bool getBool(ODPedalParameters::ParameterIndex index, const ODPedalParameters::ParameterHandles& parameters)
+            {
+                return get(index, parameters) > 0.5f;
+            }
+
+        private:
+            Values held {};
+            Values replaced {};
+            std::array<bool, ODPedalParameters::numParameters> holding {};
+    };
+}
@@ -0,0 +1,91 @@
+// image_baker: build-time conversion of editor PNGs into raw premultiplied ARGB
+//
+//   image_baker <input.png> <output.odimg> [width height]
+//
+// the output is the "ODIM" magic, little-endian uint32 width and height, then
+// width * height pixels as premultiplied B, G, R, A bytes, top row first. that
+// matches juce::PixelARGB on little-endian targets, so the plugin can copy the
+// rows straight into a juce::Image without decoding anything. when a size is
+// given the image is resampled to it first.
+
+# include <juce_graphics/juce_graphics.h>
+
+# include <cstdio>
+# include <cstdlib>
+
+namespace
+{
+    void writeU32(juce::OutputStream& out, juce::uint32 value)
+    {
+        out.writeInt(static_cast<int>(value));   // JUCE streams are little-endian
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3 && argc != 5)
+    {
+        std::fprintf(stderr, "usage: image_baker <input.png> <output.odimg> [width height]\n");
+        return 1;
+    }
+
+    juce::File inputFile(juce::File::getCurrentWorkingDirectory().getChildFile(argv[1]));
+    juce::File outputFile(juce::File::getCurrentWorkingDirectory().getChildFile(argv[2]));
+
+    juce::Image image = juce::ImageFileFormat::loadFrom(inputFile);
+    if (!image.isValid())
+    {
+        std::fprintf(stderr, "image_baker: cannot decode %s\n", argv[1]);
+        return 1;
+    }
+
+    image = image.convertedToFormat(juce::Image::ARGB);
+
+    if (argc == 5)
+    {
+        int width = std::atoi(argv[3]);
+        int height = std::atoi(argv[4]);
+        if (width <= 0 || height <= 0)
+        {
+            std::fprintf(stderr, "image_baker: bad size %s x %s\n", argv[3], argv[4]);
+            return 1;
+        }
+
+        if (width != image.getWidth() || height != image.getHeight())
+            image = image.rescaled(width, height, juce::Graphics::highResamplingQuality);
+    }
+
+    outputFile.deleteFile();
+    juce::FileOutputStream out(outputFile);
+    if (out.failedToOpen())
+    {
+        std::fprintf(stderr, "image_baker: cannot create %s\n", argv[2]);
+        return 1;
+    }
+
+    out.write("ODIM", 4);
+    writeU32(out, static_cast<juce::uint32>(image.getWidth()));
+    writeU32(out, static_cast<juce::uint32>(image.getHeight()));
+
+    // explicit byte order, independent of the build machine
+    const juce::Image::BitmapData pixels(image, juce::Image::BitmapData::readOnly);
+    juce::HeapBlock<juce::uint8> row(static_cast<size_t>(image.getWidth()) * 4);
+
+    for (int y = 0; y < image.getHeight(); ++y)
+    {
+        for (int x = 0; x < image.getWidth(); ++x)
+        {
+            const auto* pixel = reinterpret_cast<const juce::PixelARGB*>(pixels.getPixelPointer(x, y));
+            juce::uint8* destination = row + x * 4;
+            destination[0] = pixel->getBlue();
+            destination[1] = pixel->getGreen();
+            destination[2] = pixel->getRed();
+            destination[3] = pixel->getAlpha();
+        }
+
+        out.write(row, static_cast<size_t>(image.getWidth()) * 4);
+    }
+
+    out.flush();
+    return out.getStatus().wasOk() ? 0 : 1;
+}
@@ -0,0 +1,629 @@
+// od_bench: microbenchmarks for the DSP hot path, results as JSON
+//
+//   od_bench [--output file.json] [--label name] [--clipper exact|pade|poly|lut|adaa1|adaa2]
+//            [--filters serial|lookahead] [--channels n] [--repeats n] [--quick]
+//
+// the full-chain sweep covers block sizes 1..8192, sample rates 44.1k..192k and
+// static vs per-block automated tone; the component section times every filter
+// and clipper kernel, the cabinet convolution, and a program change on every
+// block as a snapshot crossfade and as a plain parameter ramp on its own, and the
+// overdrive with the touch-sensitive mode off and on. the bank section times
+// OverdriveBank with 4, 8 and 16 voices against the mono overdrive, per voice,
+// for every stateless clipper, and the layouts section runs the chain with 1
+// to 4 channels to show what each extra channel costs. each case reports the
+// best and median of --repeats trials in ns per sample (per frame for
+// multichannel runs) and the percentage of the realtime budget used. the
+// aliasing section drives every clipper with a loud sine and reports how much
+// of its output folded back.
+
+# include <algorithm>
+# include <chrono>
+# include <cmath>
+# include <cstdio>
+# include <cstdlib>
+# include <ctime>
+# include <functional>
+# include <random>
+# include <string>
+# include <utility>
+# include <vector>
+
+# include "OverdriveDSP.h"
+# include "OverdriveBank.h"
+# include "Biquad.h"
+# include "CabinetSim.h"
+# include "Saturators.h"
+# include "TanhAdaa.h"
+
+namespace
+{
+    struct BenchSettings
+    {
+        std::string outputPath;
+        std::string label;
+        SaturatorType saturator = SaturatorType::Exact;
+        FilterStructure filterStructure = FilterStructure::LookAhead;
+        int numChannels = 1;
+        int repeats = 7;
+        bool quick = false;
+    };
+
+    struct Timing
+    {
+        double bestNs = 0.0;     // per sample
+        double medianNs = 0.0;   // per sample
+    };
+
+    // audio processed per trial, large enough to swamp timer resolution
+    constexpr int samplesPerTrial = 1 << 17;
+
+    // keeps results observable so the optimizer cannot drop the work
+    volatile float sink = 0.0f;
+
+    const char* saturatorName(SaturatorType type)
+    {
+        switch (type)
+        {
+            case SaturatorType::Exact:      return "exact";
+            case SaturatorType::Pade:       return "pade";
+            case SaturatorType::Polynomial: return "poly";
+            case SaturatorType::Lookup:     return "lut";
+            case SaturatorType::Adaa1:      return "adaa1";
+            case SaturatorType::Adaa2:      return "adaa2";
+        }
+        return "exact";
+    }
+
+    bool parseSaturator(const std::string& name, SaturatorType& type)
+    {
+        if (name == "exact") type = SaturatorType::Exact;
+        else if (name == "pade") type = SaturatorType::Pade;
+        else if (name == "poly") type = SaturatorType::Polynomial;
+        else if (name == "lut") type = SaturatorType::Lookup;
+        else if (name == "adaa1") type = SaturatorType::Adaa1;
+        else if (name == "adaa2") type = SaturatorType::Adaa2;
+        else return false;
+        return true;
+    }
+
+    bool parseFilterStructure(const std::string& name, FilterStructure& structure)
+    {
+        if (name == "serial") structure = FilterStructure::Serial;
+        else if (name == "lookahead") structure = FilterStructure::LookAhead;
+        else return false;
+        return true;
+    }
+
+    // guitar-level noise, fixed seed so runs are comparable
+    std::vector<float> makeInput(int numSamples)
+    {
+        std::mt19937 generator(1234);
+        std::uniform_real_distribution<float> distribution(-0.5f, 0.5f);
+        std::vector<float> input(static_cast<std::size_t>(numSamples));
+        for (float& sample : input)
+            sample = distribution(generator);
+        return input;
+    }
+
+    // synthetic cabinet impulse: noise under an exponential decay of 60 dB over its length
+    std::vector<float> makeImpulse(float sampleRate, float seconds)
+    {
+        std::mt19937 generator(5678);
+        std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+        std::vector<float> impulse(static_cast<std::size_t>(sampleRate * seconds));
+        for (std::size_t i = 0; i < impulse.size(); ++i)
+            impulse[i] = distribution(generator) * std::pow(10.0f, -3.0f * static_cast<float>(i) / static_cast<float>(impulse.size()));
+        return impulse;
+    }
+
+    // run trial() repeats times, each processing samplesPerTrial samples
+    Timing measure(int repeats, const std::function<void()>& trial)
+    {
+        // one untimed warm-up pass for caches, branch predictors and lazy tables
+        trial();
+
+        std::vector<double> results;
+        for (int r = 0; r < repeats; ++r)
+        {
+            auto start = std::chrono::steady_clock::now();
+            trial();
+            auto end = std::chrono::steady_clock::now();
+            results.push_back(std::chrono::duration<double, std::nano>(end - start).count() / samplesPerTrial);
+        }
+
+        std::sort(results.begin(), results.end());
+        return Timing { results.front(), results[results.size() / 2] };
+    }
+
+    // helper to time the whole OverdriveDSP chain for one configuration
+    Timing benchProcess(const BenchSettings& settings, const std::vector<float>& input,
+                        int blockSize, float sampleRate, bool automateTone)
+    {
+        OverdriveDSP<float> dsp;
+        dsp.prepare(sampleRate, settings.numChannels, settings.saturator);
+        dsp.setFilterStructure(settings.filterStructure);
+
+        std::vector<std::vector<float>> channelData(static_cast<std::size_t>(settings.numChannels),
+                                                    std::vector<float>(static_cast<std::size_t>(blockSize)));
+        std::vector<float*> channelPtrs;
+        for (auto& channel : channelData)
+            channelPtrs.push_back(channel.data());
+
+        const int numBlocks = std::max(1, samplesPerTrial / blockSize);
+        const int inputBlocks = static_cast<int>(input.size()) / blockSize;
+        int blockIndex = 0;
+
+        return measure(settings.repeats, [&]()
+        {
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                const float* source = input.data() + (blockIndex++ % inputBlocks) * blockSize;
+                for (float* channel : channelPtrs)
+                    std::copy(source, source + blockSize, channel);
+
+                // tone sweeps slowly across its whole range, one new target per block
+                float tone = 3000.0f;
+                if (automateTone)
+                    tone = 800.0f + 7200.0f * (0.5f + 0.5f * std::sin(0.01f * static_cast<float>(blockIndex)));
+
+                dsp.process(channelPtrs.data(), settings.numChannels, blockSize, 12.0f, tone, 0.0f);
+            }
+            sink = sink + channelPtrs[0][blockSize - 1];
+        });
+    }
+
+    // helper to time OverdriveBank on 256-sample blocks, per voice and sample.
+    // every voice runs its own drive and tone, as they would in a batch render
+    template <int NumVoices>
+    Timing benchBank(const BenchSettings& settings, const std::vector<float>& input, SaturatorType saturator)
+    {
+        constexpr int blockSize = 256;
+        OverdriveBank<NumVoices> bank;
+        bank.prepare(48000.0f, saturator);
+
+        std::vector<std::vector<float>> voiceData(NumVoices, std::vector<float>(blockSize));
+        std::vector<float*> voicePtrs;
+        for (auto& voice : voiceData)
+            voicePtrs.push_back(voice.data());
+
+        float drive[NumVoices], tone[NumVoices], level[NumVoices];
+        for (int v = 0; v < NumVoices; ++v)
+        {
+            drive[v] = 6.0f + static_cast<float>(v % 4) * 4.0f;
+            tone[v] = 1500.0f + static_cast<float>(v) * 300.0f;
+            level[v] = 0.0f;
+        }
+
+        const int inputBlocks = static_cast<int>(input.size()) / blockSize;
+        int blockIndex = 0;
+
+        return measure(settings.repeats, [&]()
+        {
+            for (int block = 0; block < samplesPerTrial / (blockSize * NumVoices); ++block)
+            {
+                for (int v = 0; v < NumVoices; ++v)
+                {
+                    const float* source = input.data() + ((blockIndex + v) % inputBlocks) * blockSize;
+                    std::copy(source, source + blockSize, voicePtrs[v]);
+                }
+                ++blockIndex;
+                bank.process(voicePtrs.data(), blockSize, drive, tone, level);
+            }
+            sink = sink + voicePtrs[0][blockSize - 1];
+        });
+    }
+
+    // helper to time one in-place block kernel on 256-sample blocks
+    Timing benchKernel(const BenchSettings& settings, const std::vector<float>& input,
+                       const std::function<void(float*, int)>& kernel)
+    {
+        constexpr int blockSize = 256;
+        std::vector<float> buffer(blockSize);
+        const int inputBlocks = static_cast<int>(input.size()) / blockSize;
+        int blockIndex = 0;
+
+        return measure(settings.repeats, [&]()
+        {
+            for (int block = 0; block < samplesPerTrial / blockSize; ++block)
+            {
+                const float* source = input.data() + (blockIndex++ % inputBlocks) * blockSize;
+                std::copy(source, source + blockSize, buffer.data());
+                kernel(buffer.data(), blockSize);
+            }
+            sink = sink + buffer[blockSize - 1];
+        });
+    }
+
+    // aliasing test signal: a sine with a whole, odd number of cycles in
+    // aliasingLength samples. once a kernel has settled its output repeats
+    // exactly every aliasingLength samples, so each harmonic lands on one DFT
+    // bin without leakage, and harmonics above Nyquist fold onto other bins
+    constexpr int aliasingLength = 1 << 16;
+    constexpr float aliasingAmplitude = 4.0f;   // +12 dB into the clipper
+
+    // power folded back below Nyquist relative to the in-band harmonics, in dB.
+    // all power outside DC and the harmonic bins counts as aliasing
+    double measureAliasing(const std::function<void(float*, int)>& kernel, int cycles)
+    {
+        constexpr int blockSize = 256;
+        const double pi = 3.14159265358979323846;
+
+        // one settling period, then the measured one
+        std::vector<float> signal(2 * aliasingLength);
+        for (int n = 0; n < 2 * aliasingLength; ++n)
+        {
+            const int phase = static_cast<int>((static_cast<long long>(cycles) * n) % aliasingLength);
+            signal[n] = aliasingAmplitude * static_cast<float>(std::sin(2.0 * pi * phase / aliasingLength));
+        }
+        for (int start = 0; start < 2 * aliasingLength; start += blockSize)
+            kernel(signal.data() + start, blockSize);
+
+        const float* period = signal.data() + aliasingLength;
+        std::vector<double> cosTable(aliasingLength), sinTable(aliasingLength);
+        for (int n = 0; n < aliasingLength; ++n)
+        {
+            cosTable[n] = std::cos(2.0 * pi * n / aliasingLength);
+            sinTable[n] = std::sin(2.0 * pi * n / aliasingLength);
+        }
+
+        // power of one DFT bin and its mirror, normalised like the mean square
+        auto binPower = [&](int bin)
+        {
+            double re = 0.0, im = 0.0;
+            for (int n = 0; n < aliasingLength; ++n)
+            {
+                const int index = static_cast<int>((static_cast<long long>(bin) * n) % aliasingLength);
+                re += period[n] * cosTable[index];
+                im -= period[n] * sinTable[index];
+            }
+            const double scale = 1.0 / (static_cast<double>(aliasingLength) * aliasingLength);
+            return (bin == 0 ? 1.0 : 2.0) * (re * re + im * im) * scale;
+        };
+
+        double total = 0.0;
+        for (int n = 0; n < aliasingLength; ++n)
+            total += static_cast<double>(period[n]) * period[n];
+        total /= aliasingLength;
+
+        double harmonics = 0.0;
+        for (int bin = cycles; bin < aliasingLength / 2; bin += cycles)
+            harmonics += binPower(bin);
+
+        const double aliased = std::max(total - binPower(0) - harmonics, 1.0e-30);
+        return 10.0 * std::log10(aliased / harmonics);
+    }
+
+    std::string escapeJson(const std::string& text)
+    {
+        std::string escaped;
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+                escaped += '\\';
+            if (static_cast<unsigned char>(c) >= 0x20)
+                escaped += c;
+        }
+        return escaped;
+    }
+
+    std::string currentTimestamp()
+    {
+        std::time_t now = std::time(nullptr);
+        char text[32];
+        std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+        return text;
+    }
+
+    void printUsage()
+    {
+        std::fprintf(stderr,
+            "usage: od_bench [--output file.json] [--label name] [--clipper exact|pade|poly|lut|adaa1|adaa2]\n"
+            "                [--filters serial|lookahead] [--channels n] [--repeats n] [--quick]\n");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    BenchSettings settings;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        std::string value = hasValue ? argv[i + 1] : "";
+
+        if (arg == "--quick")
+        {
+            settings.quick = true;
+            continue;
+        }
+        if (arg == "--help" || arg == "-h")
+        {
+            printUsage();
+            return 0;
+        }
+        if (!hasValue)
+        {
+            std::fprintf(stderr, "missing value for %s\n", arg.c_str());
+            printUsage();
+            return 1;
+        }
+
+        if (arg == "--output") settings.outputPath = value;
+        else if (arg == "--label") settings.label = value;
+        else if (arg == "--channels") settings.numChannels = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--repeats") settings.repeats = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--clipper")
+        {
+            if (!parseSaturator(value, settings.saturator))
+            {
+                std::fprintf(stderr, "unknown clipper %s\n", value.c_str());
+                return 1;
+            }
+        }
+        else if (arg == "--filters")
+        {
+            if (!parseFilterStructure(value, settings.filterStructure))
+            {
+                std::fprintf(stderr, "unknown filter structure %s\n", value.c_str());
+                return 1;
+            }
+        }
+        else
+        {
+            std::fprintf(stderr, "unknown option %s\n", arg.c_str());
+            printUsage();
+            return 1;
+        }
+
+        ++i;
+    }
+
+    if (settings.quick)
+        settings.repeats = std::min(settings.repeats, 3);
+
+    const std::vector<float> input = makeInput(1 << 16);
+
+    std::vector<int> blockSizes;
+    for (int size = 1; size <= 8192; size *= 2)
+        blockSizes.push_back(size);
+
+    std::vector<float> sampleRates { 44100.0f, 48000.0f, 88200.0f, 96000.0f, 176400.0f, 192000.0f };
+
+    if (settings.quick)
+    {
+        blockSizes = { 1, 64, 512, 8192 };
+        sampleRates = { 48000.0f, 192000.0f };
+    }
+
+    std::FILE* out = stdout;
+    if (!settings.outputPath.empty())
+    {
+        out = std::fopen(settings.outputPath.c_str(), "w");
+        if (out == nullptr)
+        {
+            std::fprintf(stderr, "cannot create %s\n", settings.outputPath.c_str());
+            return 1;
+        }
+    }
+
+    std::fprintf(out, "{\n");
+    std::fprintf(out, "  \"schema\": 1,\n");
+    std::fprintf(out, "  \"label\": \"%s\",\n", escapeJson(settings.label).c_str());
+    std::fprintf(out, "  \"timestamp\": \"%s\",\n", currentTimestamp().c_str());
+# if defined(__VERSION__)
+    std::fprintf(out, "  \"compiler\": \"%s\",\n", escapeJson(__VERSION__).c_str());
+# endif
+    std::fprintf(out, "  \"clipper\": \"%s\",\n", saturatorName(settings.saturator));
+    std::fprintf(out, "  \"filters\": \"%s\",\n",
+                 settings.filterStructure == FilterStructure::LookAhead ? "lookahead" : "serial");
+    std::fprintf(out, "  \"channels\": %d,\n", settings.numChannels);
+    std::fprintf(out, "  \"repeats\": %d,\n", settings.repeats);
+    std::fprintf(out, "  \"samples_per_trial\": %d,\n", samplesPerTrial);
+
+    // whole chain sweep; per-sample figures are per frame, so the realtime
+    // percentage holds for every channel processed together
+    std::fprintf(out, "  \"process\": [\n");
+    bool first = true;
+    for (float sampleRate : sampleRates)
+    {
+        for (int blockSize : blockSizes)
+        {
+            for (bool automateTone : { false, true })
+            {
+                Timing timing = benchProcess(settings, input, blockSize, sampleRate, automateTone);
+                double realtimePercent = timing.medianNs * 1.0e-9 * sampleRate * 100.0;
+
+                std::fprintf(out, "%s    { \"sample_rate\": %.0f, \"block_size\": %d, \"tone\": \"%s\", "
+                                  "\"ns_per_sample\": %.3f, \"ns_per_sample_best\": %.3f, \"realtime_percent\": %.4f }",
+                             first ? "" : ",\n", sampleRate, blockSize, automateTone ? "automated" : "static",
+                             timing.medianNs, timing.bestNs, realtimePercent);
+                first = false;
+
+                std::fprintf(stderr, "process %6.0f Hz  block %5d  %-9s %8.3f ns/sample  %7.4f %% realtime\n",
+                             sampleRate, blockSize, automateTone ? "automated" : "static", timing.medianNs, realtimePercent);
+            }
+        }
+    }
+    std::fprintf(out, "\n  ],\n");
+
+    // stages in isolation at 48 kHz with 256-sample blocks
+    const float componentRate = 48000.0f;
+    BiquadCascade<1> highPass;
+    highPass.setCoefficients(0, BiquadCoefficients<float>::makeHighPass(componentRate, 720.0f, 0.707f));
+    BiquadCascade<1> postLowPass;
+    postLowPass.setCoefficients(0, BiquadCoefficients<float>::makeLowPass(componentRate, 7000.0f, 0.707f));
+    BiquadCascade<1> toneLowPass;
+    toneLowPass.setCoefficients(0, BiquadCoefficients<float>::makeLowPass(componentRate, 3000.0f, 0.707f));
+    BiquadCascade<1> rampedToneLowPass;
+    int rampStep = 0;
+
+    TanhAdaa<> firstOrderAdaa;
+    TanhAdaa<> secondOrderAdaa;
+
+    Saturators::prepareLookupTable();
+
+    // cabinet convolution, mono, with short, typical and maximum length impulses
+    CabinetSim<float> cabinets[3];
+    const float cabinetSeconds[3] = { 0.02f, 0.2f, CabinetSim<float>::maxImpulseSeconds };
+    for (int c = 0; c < 3; ++c)
+    {
+        const std::vector<float> impulse = makeImpulse(componentRate, cabinetSeconds[c]);
+        cabinets[c].prepare(componentRate, 1);
+        cabinets[c].loadImpulse(impulse.data(), static_cast<int>(impulse.size()), componentRate);
+    }
+
+    // two programs switched on every block: applied as precomputed snapshots
+    // (always crossfading) or set as parameters (always ramping the tone)
+    OverdriveDSP<float> snapshotOverdrive;
+    OverdriveDSP<float> rampOverdrive;
+    snapshotOverdrive.prepare(componentRate, 1);
+    rampOverdrive.prepare(componentRate, 1);
+    const OverdriveDSP<float>::Snapshot programs[2] = { snapshotOverdrive.makeSnapshot(2.0f, 5000.0f, 6.0f),
+                                                        snapshotOverdrive.makeSnapshot(20.0f, 1200.0f, -2.0f) };
+    int programSwitches = 0;
+
+    // the same overdrive with the touch-sensitive mode off and on, for its overhead
+    OverdriveDSP<float> plainOverdrive;
+    OverdriveDSP<float> touchOverdrive;
+    plainOverdrive.prepare(componentRate, 1);
+    touchOverdrive.prepare(componentRate, 1);
+    touchOverdrive.setEnvelopeModulation(9.0f, 1.0f);
+
+    struct Component
+    {
+        const char* name;
+        std::function<void(float*, int)> kernel;
+    };
+
+    std::vector<Component> components {
+        { "hpf", [&](float* buffer, int n) { highPass.processBlock(buffer, n); } },
+        { "post_lpf", [&](float* buffer, int n) { postLowPass.processBlock(buffer, n); } },
+        { "tone_lpf", [&](float* buffer, int n) { toneLowPass.processBlock(buffer, n); } },
+        { "hpf_lookahead", [&](float* buffer, int n) { highPass.processSectionBlockLookAhead(0, buffer, n); } },
+        { "post_lpf_lookahead", [&](float* buffer, int n) { postLowPass.processSectionBlockLookAhead(0, buffer, n); } },
+        { "tone_lpf_lookahead", [&](float* buffer, int n) { toneLowPass.processSectionBlockLookAhead(0, buffer, n); } },
+        { "tone_lpf_ramped", [&](float* buffer, int n)
+            {
+                float cutoff = 800.0f + 7200.0f * (0.5f + 0.5f * std::sin(0.01f * static_cast<float>(rampStep++)));
+                rampedToneLowPass.processSectionBlockRamped(0, buffer, n,
+                                                            BiquadCoefficients<float>::makeLowPass(componentRate, cutoff, 0.707f));
+            } },
+        { "clipper_exact", [](float* buffer, int n) { Saturators::processBlockExact(buffer, n); } },
+        { "clipper_pade", [](float* buffer, int n) { Saturators::processBlockPade(buffer, n); } },
+        { "clipper_poly", [](float* buffer, int n) { Saturators::processBlockPolynomial(buffer, n); } },
+        { "clipper_lut", [](float* buffer, int n) { Saturators::processBlockLookup(buffer, n); } },
+        { "clipper_adaa1", [&](float* buffer, int n) { firstOrderAdaa.processFirstOrder(buffer, n); } },
+        { "clipper_adaa2", [&](float* buffer, int n) { secondOrderAdaa.processSecondOrder(buffer, n); } },
+        { "cabinet_20ms", [&](float* buffer, int n) { cabinets[0].processBlock(&buffer, 1, n); } },
+        { "cabinet_200ms", [&](float* buffer, int n) { cabinets[1].processBlock(&buffer, 1, n); } },
+        { "cabinet_1s", [&](float* buffer, int n) { cabinets[2].processBlock(&buffer, 1, n); } },
+        { "program_snapshot", [&](float* buffer, int n)
+            {
+                snapshotOverdrive.applySnapshot(programs[programSwitches++ % 2]);
+                snapshotOverdrive.processBlock(&buffer, 1, n);
+            } },
+        { "program_ramp", [&](float* buffer, int n)
+            {
+                const auto& program = programs[programSwitches++ % 2];
+                rampOverdrive.process(buffer, n, program.drive, program.tone, program.level);
+            } },
+        { "overdrive", [&](float* buffer, int n) { plainOverdrive.process(buffer, n, 12.0f, 3000.0f, 0.0f); } },
+        { "overdrive_touch", [&](float* buffer, int n) { touchOverdrive.process(buffer, n, 12.0f, 3000.0f, 0.0f); } },
+    };
+
+    std::fprintf(out, "  \"components\": [\n");
+    first = true;
+    for (const Component& component : components)
+    {
+        Timing timing = benchKernel(settings, input, component.kernel);
+        double realtimePercent = timing.medianNs * 1.0e-9 * componentRate * 100.0;
+
+        std::fprintf(out, "%s    { \"name\": \"%s\", \"sample_rate\": %.0f, \"block_size\": 256, "
+                          "\"ns_per_sample\": %.3f, \"ns_per_sample_best\": %.3f, \"realtime_percent\": %.4f }",
+                     first ? "" : ",\n", component.name, componentRate, timing.medianNs, timing.bestNs, realtimePercent);
+        first = false;
+
+        std::fprintf(stderr, "component %-18s %8.3f ns/sample\n", component.name, timing.medianNs);
+    }
+    std::fprintf(out, "\n  ],\n");
+
+    // the batch engine per voice, 1 voice is OverdriveDSP on one channel
+    std::fprintf(out, "  \"bank\": [\n");
+    first = true;
+    for (SaturatorType saturator : { SaturatorType::Exact, SaturatorType::Pade, SaturatorType::Polynomial, SaturatorType::Lookup })
+    {
+        OverdriveDSP<float> monoOverdrive;
+        monoOverdrive.setFilterStructure(settings.filterStructure);
+        monoOverdrive.prepare(componentRate, 1, saturator);
+        const Timing mono = benchKernel(settings, input, [&](float* buffer, int n) { monoOverdrive.process(buffer, n, 12.0f, 3000.0f, 0.0f); });
+        const std::pair<int, Timing> timings[] = { { 1, mono },
+                                                   { 4, benchBank<4>(settings, input, saturator) },
+                                                   { 8, benchBank<8>(settings, input, saturator) },
+                                                   { 16, benchBank<16>(settings, input, saturator) } };
+
+        for (const auto& [voices, timing] : timings)
+        {
+            const double speedup = mono.medianNs / timing.medianNs;
+            std::fprintf(out, "%s    { \"clipper\": \"%s\", \"voices\": %d, \"ns_per_voice_sample\": %.3f, "
+                              "\"ns_per_voice_sample_best\": %.3f, \"speedup_vs_mono\": %.2f }",
+                         first ? "" : ",\n", saturatorName(saturator), voices, timing.medianNs, timing.bestNs, speedup);
+            first = false;
+
+            std::fprintf(stderr, "bank      %-5s %2d voices %8.3f ns/voice-sample  %5.2fx mono\n",
+                         saturatorName(saturator), voices, timing.medianNs, speedup);
+        }
+    }
+    std::fprintf(out, "\n  ],\n");
+
+    // channel layouts at 48 kHz with 512-sample blocks: mono runs in place,
+    // stereo as one 2-lane group and 3 or 4 channels as one 4-lane group
+    std::fprintf(out, "  \"layouts\": [\n");
+    first = true;
+    for (int numChannels = 1; numChannels <= 4; ++numChannels)
+    {
+        BenchSettings layoutSettings = settings;
+        layoutSettings.numChannels = numChannels;
+        const Timing timing = benchProcess(layoutSettings, input, 512, componentRate, false);
+        const double perChannel = timing.medianNs / numChannels;
+
+        std::fprintf(out, "%s    { \"channels\": %d, \"ns_per_frame\": %.3f, \"ns_per_frame_best\": %.3f, "
+                          "\"ns_per_channel_sample\": %.3f }",
+                     first ? "" : ",\n", numChannels, timing.medianNs, timing.bestNs, perChannel);
+        first = false;
+
+        std::fprintf(stderr, "layout    %d channels %8.3f ns/frame  %8.3f ns/channel-sample\n",
+                     numChannels, timing.medianNs, perChannel);
+    }
+    std::fprintf(out, "\n  ],\n");
+
+    // every clipper at 48 kHz with a fresh history, about 1 kHz and 5 kHz
+    std::fprintf(out, "  \"aliasing\": [\n");
+    first = true;
+    for (const Component& component : components)
+    {
+        if (std::string(component.name).rfind("clipper_", 0) != 0)
+            continue;
+
+        for (int cycles : { 1367, 6829 })
+        {
+            firstOrderAdaa.reset();
+            secondOrderAdaa.reset();
+            double aliasDb = measureAliasing(component.kernel, cycles);
+            double frequency = static_cast<double>(componentRate) * cycles / aliasingLength;
+
+            std::fprintf(out, "%s    { \"name\": \"%s\", \"sample_rate\": %.0f, \"frequency\": %.1f, "
+                              "\"amplitude\": %.1f, \"alias_to_signal_db\": %.2f }",
+                         first ? "" : ",\n", component.name, componentRate, frequency, aliasingAmplitude, aliasDb);
+            first = false;
+
+            std::fprintf(stderr, "aliasing  %-16s %7.1f Hz %8.2f dB\n", component.name, frequency, aliasDb);
+        }
+    }
+    std::fprintf(out, "\n  ]\n}\n");
+
+    if (out != stdout)
+        std::fclose(out);
+
+    return 0;
+}
@@ -0,0 +1,296 @@
+# include "ReferenceOverdrive.h"
+
+# include <algorithm>
+# include <cmath>
+
+void ReferenceOverdrive::Smoother::snap(float value)
+{
+    current = value;
+    target = value;
+    remaining = 0;
+    step = 0.0f;
+}
+
+void ReferenceOverdrive::Smoother::setTarget(float value)
+{
+    if (value == target)
+        return;
+
+    target = value;
+    remaining = rampSamples;
+    step = (target - current) / static_cast<float>(rampSamples);
+}
+
+float ReferenceOverdrive::Smoother::advance(int numSamples)
+{
+    if (remaining <= numSamples)
+    {
+        current = target;
+        remaining = 0;
+        return current;
+    }
+
+    current += step * static_cast<float>(numSamples);
+    remaining -= numSamples;
+    return current;
+}
+
+ReferenceOverdrive::Coefficients ReferenceOverdrive::makeLowPass(float sampleRate, float cutoff, float Q)
+{
+    float w0 = 2.0f * 3.14159265f * cutoff / sampleRate;
+    float cosW0 = std::cos(w0);
+    float alpha = std::sin(w0) / (2.0f * Q);
+    float a0 = 1.0f + alpha;
+
+    Coefficients c;
+    c.b0 = ((1.0f - cosW0) / 2.0f) / a0;
+    c.b1 = (1.0f - cosW0) / a0;
+    c.b2 = ((1.0f - cosW0) / 2.0f) / a0;
+    c.a1 = (-2.0f * cosW0) / a0;
+    c.a2 = (1.0f - alpha) / a0;
+    return c;
+}
+
+ReferenceOverdrive::Coefficients ReferenceOverdrive::makeHighPass(float sampleRate, float cutoff, float Q)
+{
+    float w0 = 2.0f * 3.14159265f * cutoff / sampleRate;
+    float cosW0 = std::cos(w0);
+    float alpha = std::sin(w0) / (2.0f * Q);
+    float a0 = 1.0f + alpha;
+
+    Coefficients c;
+    c.b0 = ((1.0f + cosW0) / 2.0f) / a0;
+    c.b1 = -(1.0f + cosW0) / a0;
+    c.b2 = ((1.0f + cosW0) / 2.0f) / a0;
+    c.a1 = (-2.0f * cosW0) / a0;
+    c.a2 = (1.0f - alpha) / a0;
+    return c;
+}
+
+double ReferenceOverdrive::antiderivative1(double input)
+{
+    const double x = std::abs(input);
+    return x - 0.69314718055994530942 + std::log1p(std::exp(-2.0 * x));
+}
+
+double ReferenceOverdrive::antiderivative2(double input)
+{
+    // log(cosh(t)) = t - log(2) + log(1 + e^-2t) for t >= 0. the last term
+    // is integrated numerically with 8-point Gauss-Legendre over unit steps; it
+    // is below 1e-17 past t = 20, where the integral stops growing
+    static constexpr double nodes[4] = { 0.18343464249564980, 0.52553240991632899,
+                                         0.79666647741362674, 0.96028985649753623 };
+    static constexpr double weights[4] = { 0.36268378337836198, 0.31370664587788729,
+                                           0.22238103445337447, 0.10122853629037626 };
+
+    const double x = std::abs(input);
+    const double end = std::min(x, 20.0);
+    double integral = 0.0;
+    for (double a = 0.0; a < end; a += 1.0)
+    {
+        const double b = std::min(a + 1.0, end);
+        const double mid = 0.5 * (a + b);
+        const double half = 0.5 * (b - a);
+        for (int k = 0; k < 4; ++k)
+        {
+            integral += weights[k] * half * (std::log1p(std::exp(-2.0 * (mid - half * nodes[k])))
+                                           + std::log1p(std::exp(-2.0 * (mid + half * nodes[k]))));
+        }
+    }
+
+    const double value = 0.5 * x * x - 0.69314718055994530942 * x + integral;
+    return input < 0.0 ? -value : value;
+}
+
+// first order: mean of tanh between the previous and the current input
+float ReferenceOverdrive::saturateFirstOrder(float input)
+{
+    const double x = input;
+    const double f1 = antiderivative1(x);
+    const double step = x - adaa.x1;
+    const double y = std::abs(step) < 1.0e-6 ? std::tanh(0.5 * (x + adaa.x1)) : (f1 - adaa.f1x1) / step;
+
+    adaa.x1 = x;
+    adaa.f1x1 = f1;
+    return static_cast<float>(y);
+}
+
+// second order: over the last two input steps, with the same fallbacks as the DSP
+float ReferenceOverdrive::saturateSecondOrder(float input)
+{
+    const double tolerance = 1.0e-4;
+    const double x = input;
+    const double f2 = antiderivative2(x);
+    const double step = x - adaa.x1;
+    const double d = std::abs(step) < tolerance ? antiderivative1(0.5 * (x + adaa.x1)) : (f2 - adaa.f2x1) / step;
+
+    double y;
+    const double span = x - adaa.x2;
+    if (std::abs(span) >= tolerance)
+    {
+        y = 2.0 * (d - adaa.d1) / span;
+    }
+    else
+    {
+        const double mid = 0.5 * (x + adaa.x2);
+        const double delta = mid - adaa.x1;
+        if (std::abs(delta) < tolerance)
+            y = std::tanh(0.5 * (mid + adaa.x1));
+        else
+            y = 2.0 / delta * (antiderivative1(mid) + (adaa.f2x1 - antiderivative2(mid)) / delta);
+    }
+
+    adaa.x2 = adaa.x1;
+    adaa.x1 = x;
+    adaa.f2x1 = f2;
+    adaa.d1 = d;
+    return static_cast<float>(y);
+}
+
+float ReferenceOverdrive::saturate(float input)
+{
+    switch (saturator)
+    {
+        case SaturatorType::Exact:
+            return std::tanh(input);
+
+        case SaturatorType::Pade:
+        {
+            float x = std::clamp(input, -5.0f, 5.0f);
+            float x2 = x * x;
+            float numerator = x * (135135.0f + x2 * (17325.0f + x2 * (378.0f + x2)));
+            float denominator = 135135.0f + x2 * (62370.0f + x2 * (3150.0f + x2 * 28.0f));
+            return std::clamp(numerator / denominator, -1.0f, 1.0f);
+        }
+
+        case SaturatorType::Polynomial:
+        {
+            float x = std::clamp(input, -3.2f, 3.2f);
+            float x2 = x * x;
+            float p = 4.057304928e-6f;
+            p = p * x2 - 1.535205563e-4f;
+            p = p * x2 + 2.366804795e-3f;
+            p = p * x2 - 1.943240501e-2f;
+            p = p * x2 + 9.534773682e-2f;
+            p = p * x2 - 3.160843556e-1f;
+            return std::clamp(x + x * x2 * p, -1.0f, 1.0f);
+        }
+
+        case SaturatorType::Lookup:
+        {
+            // 1024 intervals over [-8, 8]
+            float position = (std::clamp(input, -8.0f, 8.0f) + 8.0f) * 64.0f;
+            int index = static_cast<int>(position);
+            float fraction = position - static_cast<float>(index);
+            return lookupTable[index] + fraction * (lookupTable[index + 1] - lookupTable[index]);
+        }
+
+        case SaturatorType::Adaa1:
+            return saturateFirstOrder(input);
+
+        case SaturatorType::Adaa2:
+            return saturateSecondOrder(input);
+    }
+    return std::tanh(input);
+}
+
+void ReferenceOverdrive::prepare(float newSampleRate, SaturatorType saturatorType)
+{
+    sampleRate = newSampleRate;
+    saturator = saturatorType;
+
+    for (int i = 0; i <= 1024; ++i)
+        lookupTable[i] = static_cast<float>(std::tanh(-8.0 + static_cast<double>(i) / 64.0));
+    lookupTable[1025] = lookupTable[1024];
+
+    const int rampSamples = std::max(1, static_cast<int>(std::lround(sampleRate * 0.02f)));
+    for (Smoother* smoother : { &drive, &level, &tone })
+    {
+        *smoother = Smoother();
+        smoother->rampSamples = rampSamples;
+    }
+
+    hpf = Biquad();
+    postLPF = Biquad();
+    toneLPF = Biquad();
+    adaa = AdaaHistory();
+    hpf.c = makeHighPass(sampleRate, 720.0f, filterQ);
+    postLPF.c = makeLowPass(sampleRate, 7000.0f, filterQ);
+    toneLPF.c = makeLowPass(sampleRate, 800.0f, filterQ);
+    coefficientTone = 800.0f;
+    primed = false;
+}
+
+void ReferenceOverdrive::process(float* buffer, int numSamples, float driveDb, float toneHz, float levelDb)
+{
+    float driveLinear = std::pow(10.0f, (driveDb / 20.0f) * driveExponent);
+    float levelLinear = std::pow(10.0f, levelDb / 20.0f);
+
+    if (!primed)
+    {
+        drive.snap(driveLinear);
+        level.snap(levelLinear);
+        tone.snap(toneHz);
+        toneLPF.c = makeLowPass(sampleRate, toneHz, filterQ);
+        coefficientTone = toneHz;
+        primed = true;
+    }
+    else
+    {
+        drive.setTarget(driveLinear);
+        level.setTarget(levelLinear);
+        tone.setTarget(toneHz);
+    }
+
+    for (int start = 0; start < numSamples; start += controlInterval)
+    {
+        const int length = std::min(controlInterval, numSamples - start);
+        const float scale = 1.0f / static_cast<float>(length);
+
+        // gains ramp linearly between control points
+        float driveGain = drive.current * fixedGain;
+        const float driveStep = (drive.advance(length) * fixedGain - driveGain) * scale;
+        float levelGain = level.current;
+        const float levelStep = (level.advance(length) - levelGain) * scale;
+
+        // tone coefficients glide linearly to the control point's design
+        const float segmentTone = tone.advance(length);
+        const bool toneMoves = segmentTone != coefficientTone;
+        Coefficients toneTarget = toneLPF.c;
+        Coefficients toneStep;
+        if (toneMoves)
+        {
+            toneTarget = makeLowPass(sampleRate, segmentTone, filterQ);
+            coefficientTone = segmentTone;
+            toneStep.b0 = (toneTarget.b0 - toneLPF.c.b0) * scale;
+            toneStep.b1 = (toneTarget.b1 - toneLPF.c.b1) * scale;
+            toneStep.b2 = (toneTarget.b2 - toneLPF.c.b2) * scale;
+            toneStep.a1 = (toneTarget.a1 - toneLPF.c.a1) * scale;
+            toneStep.a2 = (toneTarget.a2 - toneLPF.c.a2) * scale;
+        }
+
+        for (int i = start; i < start + length; ++i)
+        {
+            driveGain += driveStep;
+            float x = buffer[i] * driveGain;
+            x = hpf.process(x);
+            x = saturate(x);
+            x = postLPF.process(x);
+
+            if (toneMoves)
+            {
+                toneLPF.c.b0 += toneStep.b0;
+                toneLPF.c.b1 += toneStep.b1;
+                toneLPF.c.b2 += toneStep.b2;
+                toneLPF.c.a1 += toneStep.a1;
+                toneLPF.c.a2 += toneStep.a2;
+            }
+            x = toneLPF.process(x);
+
+            levelGain += levelStep;
+            buffer[i] = x * levelGain;
+        }
+
+        toneLPF.c = toneTarget;
+    }
+}
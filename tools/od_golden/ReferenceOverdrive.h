@@ -0,0 +1,93 @@
+# pragma once
+
+# include <array>
+
+# include "Saturators.h"
+
+// frozen scalar copy of the OverdriveDSP signal path, used as the golden
+// reference for od_golden. it runs one channel one sample at a time through
+// every stage with the same control-rate smoothing, coefficient designs and
+// clipper formulas as the DSP at the time it was written. nothing here shares
+// code with src/dsp, so changes to the optimized path cannot leak into it.
+// do not optimize this class; it is only correct while it stays unchanged.
+class ReferenceOverdrive
+{
+    public:
+        // prepare for a sample rate and clipper kernel, clears all state
+        void prepare(float sampleRate, SaturatorType saturatorType);
+
+        // one block of one channel, drive/tone/level are ramp targets for the block
+        void process(float* buffer, int numSamples, float drive, float tone, float level);
+
+    private:
+        struct Coefficients
+        {
+            float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f;
+            float a1 = 0.0f, a2 = 0.0f;
+        };
+
+        struct Biquad
+        {
+            Coefficients c;
+            float s1 = 0.0f, s2 = 0.0f;
+
+            // transposed direct form II
+            float process(float input)
+            {
+                float output = c.b0 * input + s1;
+                s1 = c.b1 * input - c.a1 * output + s2;
+                s2 = c.b2 * input - c.a2 * output;
+                return output;
+            }
+        };
+
+        // linear control-rate ramp, 20 ms
+        struct Smoother
+        {
+            float current = 0.0f;
+            float target = 0.0f;
+            float step = 0.0f;
+            int rampSamples = 1;
+            int remaining = 0;
+
+            void snap(float value);
+            void setTarget(float value);
+            float advance(int numSamples);
+        };
+
+        // clipper history for the ADAA modes, double like the DSP's
+        struct AdaaHistory
+        {
+            double x1 = 0.0, x2 = 0.0;   // previous two inputs
+            double f1x1 = 0.0;           // F1(x1)
+            double f2x1 = 0.0;           // F2(x1)
+            double d1 = 0.0;             // D(x1, x2)
+        };
+
+        static Coefficients makeLowPass(float sampleRate, float cutoff, float Q);
+        static Coefficients makeHighPass(float sampleRate, float cutoff, float Q);
+        float saturate(float input);
+
+        // antiderivatives of tanh: F1 = log(cosh(x)) and F2 its integral from 0,
+        // the smooth part of F2 by Gauss-Legendre quadrature rather than a dilogarithm
+        static double antiderivative1(double x);
+        static double antiderivative2(double x);
+        float saturateFirstOrder(float input);
+        float saturateSecondOrder(float input);
+
+        // control values are recomputed every this many samples from the block start
+        static constexpr int controlInterval = 32;
+        static constexpr float filterQ = 0.707f;
+        static constexpr float fixedGain = 2.0f;
+        static constexpr float driveExponent = 1.5f;
+
+        float sampleRate = 44100.0f;
+        SaturatorType saturator = SaturatorType::Exact;
+        std::array<float, 1026> lookupTable {};
+
+        Biquad hpf, postLPF, toneLPF;
+        AdaaHistory adaa;
+        Smoother drive, level, tone;
+        float coefficientTone = 0.0f;
+        bool primed = false;
+};
@@ -0,0 +1,921 @@
+// od_golden: regression check of OverdriveDSP against a frozen scalar reference
+//
+//   od_golden [--clipper exact|pade|poly|lut|adaa1|adaa2|all] [--filters serial|lookahead|all]
+//             [--max-abs x] [--max-ulp n] [--max-spectral-db x] [--lookahead-max-abs x]
+//             [--quick] [--verbose]
+//
+// every scenario (sweep, impulses, noise, automation, silence gap, ADAA
+// fallbacks) is rendered through OverdriveDSP and through ReferenceOverdrive, a
+// one-sample-at-a-time copy of the chain as it stood when this tool was
+// written. each run reports
+// the max abs error, the max ULP distance over samples above -60 dBFS and the
+// largest difference between the two long-term spectra, and fails when any of
+// them exceeds its tolerance. the exit code is non-zero on any failure, so a
+// faster kernel can be adopted once this passes with the chosen tolerances.
+//
+// the serial filter structure must match the reference to the last few ULP.
+// the look-ahead structure runs the filter recursions in double, so it sits
+// closer to the exact result than the float reference and differs from it by
+// the reference's own rounding, amplified by up to 42 dB of gain before the
+// clipper. it is held to the spectral tolerance and a looser abs bound, and its
+// ULP distance is only reported.
+//
+// the reference integrates the ADAA2 antiderivative numerically where the DSP
+// uses a dilogarithm. the two agree to the last bits of a double, but second
+// order divides their differences twice by input steps down to 1e-4, so serial
+// ADAA2 runs are held to adaa2MaxUlp instead of --max-ulp. the adaa_fallback
+// scenario keeps both ADAA orders on their small-step fallbacks.
+//
+// two program changes inside one 10 ms crossfade must not step the output
+// more than the programs do on their own, and the second must take over.
+//
+// the touch-sensitive mode is checked against plain OverdriveDSP runs: zero
+// depths and the output after the depths return to 0 must match bit for bit,
+// non-zero depths must change the output by at least touchMinEffect.
+//
+// OverdriveBank is checked against OverdriveDSP itself: every voice of a 4-,
+// 8- and 16-voice bank has its own input and static settings and must match a
+// mono OverdriveDSP run with the same ones. its Exact clipper is
+// Saturators::tanhAccurate, so the bound is an abs one.
+//
+// each clipper kernel is also swept on its own, float and double, against
+// std::tanh and must stay within Saturators::maxAbsError, the bound its
+// documentation claims. tanhAccurate is held to tanhAccurateMaxAbsError.
+
+# include <algorithm>
+# include <cmath>
+# include <complex>
+# include <cstdint>
+# include <cstdio>
+# include <cstdlib>
+# include <cstring>
+# include <functional>
+# include <limits>
+# include <memory>
+# include <random>
+# include <string>
+# include <vector>
+
+# include "OverdriveBank.h"
+# include "OverdriveDSP.h"
+# include "ReferenceOverdrive.h"
+
+namespace
+{
+    struct Tolerances
+    {
+        double maxAbs = 1.0e-5;        // covers the silence fast path zeroing sub -120 dB tails
+        std::int64_t maxUlp = 64;
+        double maxSpectralDb = 0.1;
+    };
+
+    struct GoldenSettings
+    {
+        std::vector<SaturatorType> saturators { SaturatorType::Exact, SaturatorType::Pade, SaturatorType::Polynomial,
+                                                SaturatorType::Lookup, SaturatorType::Adaa1, SaturatorType::Adaa2 };
+        std::vector<FilterStructure> structures { FilterStructure::Serial, FilterStructure::LookAhead };
+        Tolerances tolerances;
+        Tolerances lookAheadTolerances { 1.0e-3, std::numeric_limits<std::int64_t>::max(), 0.1 };
+        std::int64_t adaa2MaxUlp = 512;   // serial ADAA2, see the header comment
+        bool quick = false;
+        bool verbose = false;
+    };
+
+    struct BlockParameters
+    {
+        float drive, tone, level;
+    };
+
+    struct Scenario
+    {
+        const char* name;
+        float sampleRate;
+        int numSamples;
+        std::function<float(int channel, int index)> input;
+        std::function<BlockParameters(int position)> parameters;   // position = first sample of the block
+    };
+
+    struct Metrics
+    {
+        double maxAbs = 0.0;
+        std::int64_t maxUlp = 0;
+        double spectralDb = 0.0;
+    };
+
+    // only samples this loud count towards the ULP distance, near zero a tiny
+    // absolute error is an enormous relative one
+    constexpr float ulpFloor = 1.0e-3f;
+
+    // long-term spectrum: Hann-windowed frames, 50 % overlap, power averaged
+    constexpr int fftOrder = 12;
+    constexpr int fftSize = 1 << fftOrder;
+
+    // bins this far below the reference spectrum's peak are not compared
+    constexpr double spectralRangeDb = 90.0;
+
+    const char* saturatorName(SaturatorType type)
+    {
+        switch (type)
+        {
+            case SaturatorType::Exact:      return "exact";
+            case SaturatorType::Pade:       return "pade";
+            case SaturatorType::Polynomial: return "poly";
+            case SaturatorType::Lookup:     return "lut";
+            case SaturatorType::Adaa1:      return "adaa1";
+            case SaturatorType::Adaa2:      return "adaa2";
+        }
+        return "exact";
+    }
+
+    const char* structureName(FilterStructure structure)
+    {
+        return structure == FilterStructure::LookAhead ? "lookahead" : "serial";
+    }
+
+    bool parseStructures(const std::string& name, std::vector<FilterStructure>& structures)
+    {
+        if (name == "all") structures = { FilterStructure::Serial, FilterStructure::LookAhead };
+        else if (name == "serial") structures = { FilterStructure::Serial };
+        else if (name == "lookahead") structures = { FilterStructure::LookAhead };
+        else return false;
+        return true;
+    }
+
+    bool parseSaturators(const std::string& name, std::vector<SaturatorType>& types)
+    {
+        if (name == "all") types = { SaturatorType::Exact, SaturatorType::Pade, SaturatorType::Polynomial, SaturatorType::Lookup,
+                                     SaturatorType::Adaa1, SaturatorType::Adaa2 };
+        else if (name == "exact") types = { SaturatorType::Exact };
+        else if (name == "pade") types = { SaturatorType::Pade };
+        else if (name == "poly") types = { SaturatorType::Polynomial };
+        else if (name == "lut") types = { SaturatorType::Lookup };
+        else if (name == "adaa1") types = { SaturatorType::Adaa1 };
+        else if (name == "adaa2") types = { SaturatorType::Adaa2 };
+        else return false;
+        return true;
+    }
+
+    // distance in representable floats, sign-aware
+    std::int64_t ulpDistance(float a, float b)
+    {
+        auto ordered = [](float value)
+        {
+            std::int32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits < 0 ? static_cast<std::int64_t>(INT32_MIN) - bits : static_cast<std::int64_t>(bits);
+        };
+        return std::llabs(ordered(a) - ordered(b));
+    }
+
+    // in-place iterative radix-2 FFT
+    void fft(std::vector<std::complex<double>>& data)
+    {
+        const std::size_t n = data.size();
+        for (std::size_t i = 1, j = 0; i < n; ++i)
+        {
+            std::size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1)
+                j ^= bit;
+            j ^= bit;
+            if (i < j)
+                std::swap(data[i], data[j]);
+        }
+
+        for (std::size_t length = 2; length <= n; length <<= 1)
+        {
+            const double angle = -2.0 * 3.14159265358979323846 / static_cast<double>(length);
+            const std::complex<double> rotation(std::cos(angle), std::sin(angle));
+            for (std::size_t start = 0; start < n; start += length)
+            {
+                std::complex<double> twiddle(1.0, 0.0);
+                for (std::size_t k = 0; k < length / 2; ++k)
+                {
+                    std::complex<double> even = data[start + k];
+                    std::complex<double> odd = data[start + k + length / 2] * twiddle;
+                    data[start + k] = even + odd;
+                    data[start + k + length / 2] = even - odd;
+                    twiddle *= rotation;
+                }
+            }
+        }
+    }
+
+    std::vector<double> longTermSpectrum(const std::vector<float>& signal)
+    {
+        std::vector<double> power(fftSize / 2 + 1, 0.0);
+        std::vector<std::complex<double>> frame(fftSize);
+        int numFrames = 0;
+
+        for (std::size_t start = 0; start + fftSize <= signal.size(); start += fftSize / 2, ++numFrames)
+        {
+            for (int i = 0; i < fftSize; ++i)
+            {
+                double window = 0.5 - 0.5 * std::cos(2.0 * 3.14159265358979323846 * i / fftSize);
+                frame[i] = { signal[start + i] * window, 0.0 };
+            }
+
+            fft(frame);
+            for (int bin = 0; bin <= fftSize / 2; ++bin)
+                power[bin] += std::norm(frame[bin]);
+        }
+
+        for (double& value : power)
+            value /= std::max(1, numFrames);
+        return power;
+    }
+
+    // largest dB difference over the bins within spectralRangeDb of the reference peak
+    double spectralDifference(const std::vector<float>& reference, const std::vector<float>& test)
+    {
+        std::vector<double> referencePower = longTermSpectrum(reference);
+        std::vector<double> testPower = longTermSpectrum(test);
+        const double peak = *std::max_element(referencePower.begin(), referencePower.end());
+        if (peak <= 0.0)
+            return 0.0;
+
+        const double floor = peak * std::pow(10.0, -spectralRangeDb / 10.0);
+        double worst = 0.0;
+        for (std::size_t bin = 1; bin < referencePower.size(); ++bin)
+        {
+            if (referencePower[bin] < floor)
+                continue;
+            double difference = 10.0 * std::log10(std::max(testPower[bin], floor * 1.0e-3) / referencePower[bin]);
+            worst = std::max(worst, std::abs(difference));
+        }
+        return worst;
+    }
+
+    // render one scenario through both implementations and compare
+    Metrics runScenario(const Scenario& scenario, SaturatorType saturator, FilterStructure structure,
+                        int numChannels, int blockSize)
+    {
+        const std::size_t length = static_cast<std::size_t>(scenario.numSamples);
+        std::vector<std::vector<float>> test(numChannels, std::vector<float>(length));
+        std::vector<std::vector<float>> reference(numChannels, std::vector<float>(length));
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            for (int i = 0; i < scenario.numSamples; ++i)
+                test[channel][i] = reference[channel][i] = scenario.input(channel, i);
+        }
+
+        OverdriveDSP<float> dsp;
+        dsp.prepare(scenario.sampleRate, numChannels, saturator);
+        dsp.setFilterStructure(structure);
+        std::vector<ReferenceOverdrive> references(numChannels);
+        for (auto& channel : references)
+            channel.prepare(scenario.sampleRate, saturator);
+
+        std::vector<float*> channelPtrs(numChannels);
+        for (int start = 0; start < scenario.numSamples; start += blockSize)
+        {
+            const int numFrames = std::min(blockSize, scenario.numSamples - start);
+            const BlockParameters p = scenario.parameters(start);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                channelPtrs[channel] = test[channel].data() + start;
+                references[channel].process(reference[channel].data() + start, numFrames, p.drive, p.tone, p.level);
+            }
+            dsp.process(channelPtrs.data(), numChannels, numFrames, p.drive, p.tone, p.level);
+        }
+
+        Metrics metrics;
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                const float expected = reference[channel][i];
+                const float actual = test[channel][i];
+                metrics.maxAbs = std::max(metrics.maxAbs, static_cast<double>(std::abs(expected - actual)));
+                if (std::abs(expected) >= ulpFloor)
+                    metrics.maxUlp = std::max(metrics.maxUlp, ulpDistance(expected, actual));
+            }
+            metrics.spectralDb = std::max(metrics.spectralDb, spectralDifference(reference[channel], test[channel]));
+        }
+        return metrics;
+    }
+
+    // inputs for the kernel sweeps: a dense grid over the curved part of tanh
+    // plus values far into saturation and the float extremes
+    template <typename Sample>
+    std::vector<Sample> makeKernelSweep()
+    {
+        std::vector<Sample> inputs;
+        for (int i = -16 * 4096; i <= 16 * 4096; ++i)
+            inputs.push_back(static_cast<Sample>(i) / Sample(4096));
+
+        for (Sample value : { Sample(100), Sample(1.0e6), static_cast<Sample>(std::numeric_limits<float>::max()),
+                              std::numeric_limits<Sample>::infinity() })
+        {
+            inputs.push_back(value);
+            inputs.push_back(-value);
+        }
+        return inputs;
+    }
+
+    // worst abs error of a block kernel against std::tanh in the same precision
+    template <typename Sample>
+    double sweepKernel(SaturatorType type)
+    {
+        const std::vector<Sample> inputs = makeKernelSweep<Sample>();
+        std::vector<Sample> outputs = inputs;
+        Saturators::processBlock(type, outputs.data(), static_cast<int>(outputs.size()));
+
+        double worst = 0.0;
+        for (std::size_t i = 0; i < inputs.size(); ++i)
+            worst = std::max(worst, std::abs(static_cast<double>(outputs[i]) - static_cast<double>(std::tanh(inputs[i]))));
+        return worst;
+    }
+
+    double sweepTanhAccurate()
+    {
+        double worst = 0.0;
+        for (float input : makeKernelSweep<float>())
+            worst = std::max(worst, std::abs(static_cast<double>(Saturators::tanhAccurate(input)) - static_cast<double>(std::tanh(input))));
+        return worst;
+    }
+
+    // bank voices against mono OverdriveDSP runs, worst abs error over all voices.
+    // the last voice is left unused to check it does not disturb the others
+    constexpr double bankMaxAbs = 1.0e-5;
+
+    template <int NumVoices>
+    double compareBank(SaturatorType saturator, int blockSize, int numSamples)
+    {
+        const float sampleRate = 48000.0f;
+        std::vector<std::vector<float>> bankOutput(NumVoices, std::vector<float>(static_cast<std::size_t>(numSamples)));
+        std::vector<std::vector<float>> monoOutput(NumVoices);
+        float drive[NumVoices], tone[NumVoices], level[NumVoices];
+
+        for (int v = 0; v < NumVoices; ++v)
+        {
+            std::mt19937 generator(2000 + v);
+            std::uniform_real_distribution<float> distribution(-0.5f, 0.5f);
+            for (float& sample : bankOutput[v])
+                sample = distribution(generator);
+            monoOutput[v] = bankOutput[v];
+
+            drive[v] = static_cast<float>(v % 5) * 6.0f;
+            tone[v] = 800.0f + static_cast<float>(v) * 450.0f;
+            level[v] = static_cast<float>(v % 3) * 6.0f - 6.0f;
+        }
+
+        OverdriveBank<NumVoices> bank;
+        bank.prepare(sampleRate, saturator);
+        std::vector<float*> voicePtrs(NumVoices, nullptr);
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            const int numFrames = std::min(blockSize, numSamples - start);
+            for (int v = 0; v < NumVoices - 1; ++v)
+                voicePtrs[v] = bankOutput[v].data() + start;
+            bank.process(voicePtrs.data(), numFrames, drive, tone, level);
+        }
+
+        double worst = 0.0;
+        for (int v = 0; v < NumVoices - 1; ++v)
+        {
+            OverdriveDSP<float> dsp;
+            dsp.prepare(sampleRate, 1, saturator);
+            dsp.setFilterStructure(FilterStructure::Serial);
+            for (int start = 0; start < numSamples; start += blockSize)
+                dsp.process(monoOutput[v].data() + start, std::min(blockSize, numSamples - start), drive[v], tone[v], level[v]);
+
+            for (int i = 0; i < numSamples; ++i)
+                worst = std::max(worst, static_cast<double>(std::abs(bankOutput[v][i] - monoOutput[v][i])));
+        }
+        return worst;
+    }
+
+    // touch-sensitive mode against plain OverdriveDSP runs of the same input.
+    // zero depths must not change a single bit and real depths must audibly
+    // move the output. once the depths are back at 0 the modulation has to come
+    // to rest on the plain path, so after the filter state from the modulated
+    // part has died away the output matches the plain run bit for bit
+    struct TouchDepths
+    {
+        float drive, tone;   // dB, octaves
+    };
+
+    struct TouchMetrics
+    {
+        double restingAbs = 0.0;     // depths 0, 0 against plain, must be 0
+        double modulatedAbs = 0.0;   // while modulating, must reach touchMinEffect
+        double settledAbs = 0.0;     // touchSettleSeconds after the depths return to 0, must be 0
+        bool finite = true;
+    };
+
+    constexpr double touchMinEffect = 1.0e-2;
+    constexpr float touchSettleSeconds = 0.05f;
+
+    TouchMetrics compareTouch(SaturatorType saturator, FilterStructure structure, TouchDepths depths,
+                              int numChannels, int blockSize, int numSamples)
+    {
+        // plucked notes: noise bursts decaying over 100 ms, four a second, so the
+        // envelope keeps crossing the modulation range
+        const float sampleRate = 48000.0f;
+        const std::size_t length = static_cast<std::size_t>(numSamples);
+        std::vector<std::vector<float>> plain(numChannels, std::vector<float>(length));
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            std::mt19937 generator(3000 + channel);
+            std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+            for (int i = 0; i < numSamples; ++i)
+                plain[channel][i] = 0.6f * std::exp(-static_cast<float>(i % 12000) / 4800.0f) * distribution(generator);
+        }
+        std::vector<std::vector<float>> resting = plain;
+        std::vector<std::vector<float>> touch = plain;
+
+        OverdriveDSP<float> dsps[3];
+        for (auto& dsp : dsps)
+        {
+            dsp.prepare(sampleRate, numChannels, saturator);
+            dsp.setFilterStructure(structure);
+        }
+
+        // the depths are switched off halfway, at a block boundary
+        const int touchEnd = numSamples / 2 / blockSize * blockSize;
+        std::vector<float*> channelPtrs(numChannels);
+        std::vector<std::vector<float>>* outputs[3] = { &plain, &resting, &touch };
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            const int numFrames = std::min(blockSize, numSamples - start);
+            dsps[1].setEnvelopeModulation(0.0f, 0.0f);
+            if (start < touchEnd)
+                dsps[2].setEnvelopeModulation(depths.drive, depths.tone);
+            else
+                dsps[2].setEnvelopeModulation(0.0f, 0.0f);
+
+            for (int d = 0; d < 3; ++d)
+            {
+                for (int channel = 0; channel < numChannels; ++channel)
+                    channelPtrs[channel] = (*outputs[d])[channel].data() + start;
+                dsps[d].process(channelPtrs.data(), numChannels, numFrames, 12.0f, 2000.0f, 0.0f);
+            }
+        }
+
+        TouchMetrics metrics;
+        const int settled = touchEnd + static_cast<int>(touchSettleSeconds * sampleRate);
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float expected = plain[channel][i];
+                metrics.finite &= std::isfinite(touch[channel][i]);
+                metrics.restingAbs = std::max(metrics.restingAbs, static_cast<double>(std::abs(resting[channel][i] - expected)));
+
+                const double error = std::abs(touch[channel][i] - expected);
+                if (i < touchEnd)
+                    metrics.modulatedAbs = std::max(metrics.modulatedAbs, error);
+                else if (i >= settled)
+                    metrics.settledAbs = std::max(metrics.settledAbs, error);
+            }
+        }
+        return metrics;
+    }
+
+    // program changes closer together than the crossfade must not cut off a
+    // program that is still audible. the largest sample-to-sample step across
+    // two changes may exceed the steepest step of each program on its own by at
+    // most programStepRatio, and the second program must still take over: half
+    // a second later the output matches it within bankMaxAbs
+    constexpr double programStepRatio = 1.25;
+
+    struct ProgramChangeMetrics
+    {
+        double stepRatio = 0.0;
+        double finalAbs = 0.0;
+    };
+
+    ProgramChangeMetrics compareProgramChanges(SaturatorType saturator, FilterStructure structure, int numChannels,
+                                 int blockSize, int gapSamples)
+    {
+        const float sampleRate = 48000.0f;
+        const int numSamples = 48000;
+        const int firstChange = 24000;
+        const int settled = 4800;   // the start-up transient is not part of the bound
+
+        OverdriveDSP<float> designer;
+        designer.prepare(sampleRate, 1, saturator);
+        const OverdriveDSP<float>::Snapshot programs[3] = { designer.makeSnapshot(2.0f, 5000.0f, 6.0f),
+                                                            designer.makeSnapshot(20.0f, 1200.0f, -2.0f),
+                                                            designer.makeSnapshot(10.0f, 3000.0f, 0.0f) };
+
+        const auto input = [](int channel, int i)
+        {
+            return 0.5f * std::sin(0.0288f * static_cast<float>(i) + 0.7f * static_cast<float>(channel));
+        };
+
+        // the first program from the start, the others switched in gapSamples apart;
+        // a change always lands on a block boundary
+        const auto render = [&](std::initializer_list<std::pair<int, int>> changes)
+        {
+            std::vector<std::vector<float>> output(numChannels, std::vector<float>(static_cast<std::size_t>(numSamples)));
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                for (int i = 0; i < numSamples; ++i)
+                    output[channel][i] = input(channel, i);
+            }
+
+            OverdriveDSP<float> dsp;
+            dsp.prepare(sampleRate, numChannels, saturator);
+            dsp.setFilterStructure(structure);
+            std::vector<float*> channelPtrs(numChannels);
+            for (int start = 0; start < numSamples;)
+            {
+                int end = std::min(numSamples, start + blockSize);
+                for (const auto& change : changes)
+                {
+                    if (change.first == start)
+                        dsp.applySnapshot(programs[change.second]);
+                    else if (change.first > start)
+                        end = std::min(end, change.first);
+                }
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                    channelPtrs[channel] = output[channel].data() + start;
+                dsp.processBlock(channelPtrs.data(), numChannels, end - start);
+                start = end;
+            }
+            return output;
+        };
+
+        const auto largestStep = [&](const std::vector<std::vector<float>>& output)
+        {
+            double largest = 0.0;
+            for (const auto& channel : output)
+            {
+                for (int i = settled + 1; i < numSamples; ++i)
+                    largest = std::max(largest, static_cast<double>(std::abs(channel[i] - channel[i - 1])));
+            }
+            return largest;
+        };
+
+        double bound = 0.0;
+        std::vector<std::vector<float>> last;
+        for (int p = 0; p < 3; ++p)
+        {
+            last = render({ { 0, p } });
+            bound = std::max(bound, largestStep(last));
+        }
+
+        const auto switched = render({ { 0, 0 }, { firstChange, 1 }, { firstChange + gapSamples, 2 } });
+        ProgramChangeMetrics metrics;
+        metrics.stepRatio = largestStep(switched) / bound;
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            for (int i = numSamples - settled; i < numSamples; ++i)
+                metrics.finalAbs = std::max(metrics.finalAbs, static_cast<double>(std::abs(switched[channel][i] - last[channel][i])));
+        }
+        return metrics;
+    }
+
+    std::vector<Scenario> makeScenarios(bool quick)
+    {
+        const int seconds = quick ? 1 : 3;
+        std::vector<Scenario> scenarios;
+
+        const auto staticParameters = [](float drive, float tone, float level)
+        {
+            return [=](int) { return BlockParameters { drive, tone, level }; };
+        };
+
+        for (float sampleRate : { 48000.0f, 96000.0f })
+        {
+            const int numSamples = static_cast<int>(sampleRate) * seconds;
+            const double duration = static_cast<double>(numSamples) / sampleRate;
+
+            // exponential sine sweep 20 Hz .. 20 kHz, channels offset in phase
+            scenarios.push_back({ "sweep", sampleRate, numSamples,
+                [=](int channel, int i)
+                {
+                    const double t = i / static_cast<double>(sampleRate);
+                    const double k = std::log(20000.0 / 20.0);
+                    const double phase = 2.0 * 3.14159265358979323846 * 20.0 * duration / k * (std::exp(t / duration * k) - 1.0);
+                    return static_cast<float>(0.5 * std::sin(phase + 0.7 * channel));
+                },
+                staticParameters(12.0f, 3000.0f, 0.0f) });
+
+            // full-scale clicks ten times a second
+            scenarios.push_back({ "impulses", sampleRate, numSamples,
+                [=](int channel, int i) { return (i + 37 * channel) % static_cast<int>(sampleRate / 10.0f) == 0 ? 1.0f : 0.0f; },
+                staticParameters(18.0f, 5000.0f, 3.0f) });
+        }
+
+        const float sampleRate = 48000.0f;
+        const int numSamples = static_cast<int>(sampleRate) * seconds;
+
+        // white noise, fixed seeds, one stream per channel
+        auto noise = std::make_shared<std::vector<std::vector<float>>>();
+        for (int channel = 0; channel < 8; ++channel)
+        {
+            std::mt19937 generator(1000 + channel);
+            std::uniform_real_distribution<float> distribution(-0.5f, 0.5f);
+            noise->emplace_back(numSamples);
+            for (float& sample : noise->back())
+                sample = distribution(generator);
+        }
+
+        scenarios.push_back({ "noise", sampleRate, numSamples,
+            [=](int channel, int i) { return (*noise)[channel % 8][i]; },
+            staticParameters(6.0f, 1500.0f, 6.0f) });
+
+        // every parameter swept across its whole range at different rates
+        scenarios.push_back({ "automation", sampleRate, numSamples,
+            [=](int channel, int i)
+            {
+                return 0.3f * std::sin(0.02f * static_cast<float>(i)) + 0.5f * (*noise)[channel % 8][i];
+            },
+            [](int position)
+            {
+                const float t = static_cast<float>(position);
+                return BlockParameters { 12.0f + 12.0f * std::sin(0.00031f * t),
+                                         4400.0f + 3600.0f * std::sin(0.00017f * t),
+                                         12.0f * std::sin(0.00023f * t) };
+            } });
+
+        // signal, a second of silence while the parameters jump, then signal again
+        scenarios.push_back({ "silence_gap", sampleRate, numSamples + static_cast<int>(sampleRate),
+            [=](int channel, int i)
+            {
+                const int gapStart = numSamples / 2;
+                if (i >= gapStart && i < gapStart + static_cast<int>(sampleRate))
+                    return 0.0f;
+                return 0.4f * std::sin(0.05f * static_cast<float>(i) + static_cast<float>(channel));
+            },
+            [=](int position)
+            {
+                return position < numSamples / 2 + static_cast<int>(sampleRate) / 2
+                    ? BlockParameters { 9.0f, 2000.0f, 0.0f }
+                    : BlockParameters { 20.0f, 6000.0f, -6.0f };
+            } });
+
+        // inputs that keep the ADAA clippers on their ill-conditioned fallbacks:
+        // a slow sine, which the high-pass leaves moving by far less than the
+        // step tolerances per sample, then a Nyquist-rate square wave, where
+        // every input matches the one two samples back
+        scenarios.push_back({ "adaa_fallback", sampleRate, numSamples,
+            [=](int channel, int i)
+            {
+                if (i < numSamples / 2)
+                    return 0.5f * std::sin(0.0002f * static_cast<float>(i) + static_cast<float>(channel));
+                return (i % 2 == 0 ? 0.05f : -0.05f) * (1.0f + 0.1f * static_cast<float>(channel));
+            },
+            staticParameters(24.0f, 6000.0f, 0.0f) });
+
+        return scenarios;
+    }
+
+    void printUsage()
+    {
+        std::fprintf(stderr,
+            "usage: od_golden [--clipper exact|pade|poly|lut|adaa1|adaa2|all] [--filters serial|lookahead|all]\n"
+            "                 [--max-abs x] [--max-ulp n] [--max-spectral-db x] [--lookahead-max-abs x]\n"
+            "                 [--quick] [--verbose]\n");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    GoldenSettings settings;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        std::string value = hasValue ? argv[i + 1] : "";
+
+        if (arg == "--quick" || arg == "--verbose")
+        {
+            (arg == "--quick" ? settings.quick : settings.verbose) = true;
+            continue;
+        }
+        if (arg == "--help" || arg == "-h")
+        {
+            printUsage();
+            return 0;
+        }
+        if (!hasValue)
+        {
+            std::fprintf(stderr, "missing value for %s\n", arg.c_str());
+            printUsage();
+            return 1;
+        }
+
+        if (arg == "--max-abs") settings.tolerances.maxAbs = std::strtod(value.c_str(), nullptr);
+        else if (arg == "--max-ulp") settings.tolerances.maxUlp = std::strtoll(value.c_str(), nullptr, 10);
+        else if (arg == "--max-spectral-db")
+            settings.tolerances.maxSpectralDb = settings.lookAheadTolerances.maxSpectralDb = std::strtod(value.c_str(), nullptr);
+        else if (arg == "--lookahead-max-abs") settings.lookAheadTolerances.maxAbs = std::strtod(value.c_str(), nullptr);
+        else if (arg == "--filters")
+        {
+            if (!parseStructures(value, settings.structures))
+            {
+                std::fprintf(stderr, "unknown filter structure %s\n", value.c_str());
+                return 1;
+            }
+        }
+        else if (arg == "--clipper")
+        {
+            if (!parseSaturators(value, settings.saturators))
+            {
+                std::fprintf(stderr, "unknown clipper %s\n", value.c_str());
+                return 1;
+            }
+        }
+        else
+        {
+            std::fprintf(stderr, "unknown option %s\n", arg.c_str());
+            printUsage();
+            return 1;
+        }
+
+        ++i;
+    }
+
+    // odd sizes cross the 32-sample control and 256-frame chunk boundaries,
+    // 2 channels run the 2-lane pair group, 3 one 4-lane group with an idle lane
+    std::vector<int> blockSizes { 1, 37, 256, 4096 };
+    std::vector<int> channelCounts { 1, 2, 3 };
+    if (settings.quick)
+        blockSizes = { 37, 4096 };
+
+    const Tolerances& serialLimits = settings.tolerances;
+    std::printf("tolerances: max abs %.3g, max ulp %lld (above %.0f dBFS), spectrum %.3g dB; lookahead max abs %.3g\n",
+                serialLimits.maxAbs, static_cast<long long>(serialLimits.maxUlp), 20.0 * std::log10(ulpFloor),
+                serialLimits.maxSpectralDb, settings.lookAheadTolerances.maxAbs);
+
+    int numRuns = 0;
+    int numFailures = 0;
+
+    Saturators::prepareLookupTable();
+    for (SaturatorType saturator : settings.saturators)
+    {
+        const double limit = Saturators::maxAbsError(saturator);
+        for (bool isDouble : { false, true })
+        {
+            const double error = isDouble ? sweepKernel<double>(saturator) : sweepKernel<float>(saturator);
+            const bool pass = error <= limit;
+            ++numRuns;
+            numFailures += pass ? 0 : 1;
+            std::printf("%s kernel %-5s %-6s  abs %.3g (max %.3g)\n", pass ? "pass" : "FAIL",
+                        saturatorName(saturator), isDouble ? "double" : "float", error, limit);
+        }
+    }
+
+    {
+        const double error = sweepTanhAccurate();
+        const bool pass = error <= Saturators::tanhAccurateMaxAbsError;
+        ++numRuns;
+        numFailures += pass ? 0 : 1;
+        std::printf("%s kernel tanhAccurate float   abs %.3g (max %.3g)\n", pass ? "pass" : "FAIL",
+                    error, static_cast<double>(Saturators::tanhAccurateMaxAbsError));
+    }
+
+    for (const Scenario& scenario : makeScenarios(settings.quick))
+    {
+        for (SaturatorType saturator : settings.saturators)
+        for (FilterStructure structure : settings.structures)
+        {
+            Tolerances limits = structure == FilterStructure::LookAhead ? settings.lookAheadTolerances
+                                                                         : settings.tolerances;
+            if (structure == FilterStructure::Serial && saturator == SaturatorType::Adaa2)
+                limits.maxUlp = std::max(limits.maxUlp, settings.adaa2MaxUlp);
+            Metrics worst;
+            bool failed = false;
+
+            for (int numChannels : channelCounts)
+            {
+                for (int blockSize : blockSizes)
+                {
+                    Metrics metrics = runScenario(scenario, saturator, structure, numChannels, blockSize);
+                    bool pass = metrics.maxAbs <= limits.maxAbs && metrics.maxUlp <= limits.maxUlp
+                             && metrics.spectralDb <= limits.maxSpectralDb;
+                    ++numRuns;
+
+                    if (!pass || settings.verbose)
+                    {
+                        std::printf("  %s %-12s %6.0f Hz  %-5s  %-9s  %d ch  block %4d  abs %.3g  ulp %lld  spectrum %.3g dB\n",
+                                    pass ? "ok  " : "FAIL", scenario.name, scenario.sampleRate, saturatorName(saturator),
+                                    structureName(structure), numChannels, blockSize, metrics.maxAbs, static_cast<long long>(metrics.maxUlp),
+                                    metrics.spectralDb);
+                    }
+
+                    worst.maxAbs = std::max(worst.maxAbs, metrics.maxAbs);
+                    worst.maxUlp = std::max(worst.maxUlp, metrics.maxUlp);
+                    worst.spectralDb = std::max(worst.spectralDb, metrics.spectralDb);
+                    failed |= !pass;
+                    numFailures += pass ? 0 : 1;
+                }
+            }
+
+            std::printf("%s %-12s %6.0f Hz  %-5s  %-9s  abs %.3g  ulp %lld  spectrum %.3g dB\n",
+                        failed ? "FAIL" : "pass", scenario.name, scenario.sampleRate, saturatorName(saturator),
+                        structureName(structure), worst.maxAbs, static_cast<long long>(worst.maxUlp), worst.spectralDb);
+        }
+    }
+
+    // the bank only has the stateless clippers
+    for (SaturatorType saturator : settings.saturators)
+    {
+        if (saturator == SaturatorType::Adaa1 || saturator == SaturatorType::Adaa2)
+            continue;
+
+        const int numSamples = settings.quick ? 24000 : 96000;
+        for (int voices : { 4, 8, 16 })
+        {
+            double worst = 0.0;
+            for (int blockSize : blockSizes)
+            {
+                const double error = voices == 4 ? compareBank<4>(saturator, blockSize, numSamples)
+                                   : voices == 8 ? compareBank<8>(saturator, blockSize, numSamples)
+                                                 : compareBank<16>(saturator, blockSize, numSamples);
+                const bool pass = error <= bankMaxAbs;
+                ++numRuns;
+                numFailures += pass ? 0 : 1;
+                worst = std::max(worst, error);
+
+                if (!pass || settings.verbose)
+                    std::printf("  %s bank %2d voices  %-5s  block %4d  abs %.3g\n",
+                                pass ? "ok  " : "FAIL", voices, saturatorName(saturator), blockSize, error);
+            }
+
+            std::printf("%s bank %2d voices  %-5s  abs %.3g (max %.3g)\n", worst <= bankMaxAbs ? "pass" : "FAIL",
+                        voices, saturatorName(saturator), worst, bankMaxAbs);
+        }
+    }
+
+    // drive only, tone only, both, and a tone that closes as the playing gets louder
+    for (SaturatorType saturator : settings.saturators)
+    for (FilterStructure structure : settings.structures)
+    {
+        const int numSamples = settings.quick ? 48000 : 144000;
+        for (TouchDepths depths : { TouchDepths { 9.0f, 0.0f }, TouchDepths { 0.0f, 1.0f },
+                                    TouchDepths { 9.0f, 1.0f }, TouchDepths { 6.0f, -1.0f } })
+        {
+            TouchMetrics worst;
+            worst.modulatedAbs = std::numeric_limits<double>::max();
+            bool failed = false;
+
+            for (int numChannels : channelCounts)
+            {
+                for (int blockSize : blockSizes)
+                {
+                    const TouchMetrics metrics = compareTouch(saturator, structure, depths, numChannels, blockSize, numSamples);
+                    const bool pass = metrics.finite && metrics.restingAbs == 0.0 && metrics.modulatedAbs >= touchMinEffect
+                                   && metrics.settledAbs == 0.0;
+                    ++numRuns;
+
+                    if (!pass || settings.verbose)
+                    {
+                        std::printf("  %s touch %4.1f dB %4.1f oct  %-5s  %-9s  %d ch  block %4d  resting %.3g  modulated %.3g  settled %.3g\n",
+                                    pass ? "ok  " : "FAIL", depths.drive, depths.tone, saturatorName(saturator),
+                                    structureName(structure), numChannels, blockSize, metrics.restingAbs,
+                                    metrics.modulatedAbs, metrics.settledAbs);
+                    }
+
+                    worst.restingAbs = std::max(worst.restingAbs, metrics.restingAbs);
+                    worst.modulatedAbs = std::min(worst.modulatedAbs, metrics.modulatedAbs);
+                    worst.settledAbs = std::max(worst.settledAbs, metrics.settledAbs);
+                    failed |= !pass;
+                    numFailures += pass ? 0 : 1;
+                }
+            }
+
+            std::printf("%s touch %4.1f dB %4.1f oct  %-5s  %-9s  resting %.3g  modulated %.3g (min %.3g)  settled %.3g\n",
+                        failed ? "FAIL" : "pass", depths.drive, depths.tone, saturatorName(saturator), structureName(structure),
+                        worst.restingAbs, worst.modulatedAbs, touchMinEffect, worst.settledAbs);
+        }
+    }
+
+    // second program change 1, 5 and 9 ms after the first, inside its 10 ms fade
+    for (SaturatorType saturator : settings.saturators)
+    for (FilterStructure structure : settings.structures)
+    {
+        ProgramChangeMetrics worst;
+        bool failed = false;
+        for (int numChannels : channelCounts)
+        for (int blockSize : blockSizes)
+        for (int gapSamples : { 48, 240, 432 })
+        {
+            const ProgramChangeMetrics metrics = compareProgramChanges(saturator, structure, numChannels, blockSize, gapSamples);
+            const bool pass = metrics.stepRatio <= programStepRatio && metrics.finalAbs <= bankMaxAbs;
+            ++numRuns;
+            numFailures += pass ? 0 : 1;
+            failed |= !pass;
+            worst.stepRatio = std::max(worst.stepRatio, metrics.stepRatio);
+            worst.finalAbs = std::max(worst.finalAbs, metrics.finalAbs);
+
+            if (!pass || settings.verbose)
+                std::printf("  %s programs  %-5s  %-9s  %d ch  block %4d  gap %3d  step ratio %.3g  final abs %.3g\n",
+                            pass ? "ok  " : "FAIL", saturatorName(saturator), structureName(structure),
+                            numChannels, blockSize, gapSamples, metrics.stepRatio, metrics.finalAbs);
+        }
+
+        std::printf("%s programs  %-5s  %-9s  step ratio %.3g (max %.3g)  final abs %.3g (max %.3g)\n",
+                    failed ? "FAIL" : "pass", saturatorName(saturator), structureName(structure),
+                    worst.stepRatio, programStepRatio, worst.finalAbs, bankMaxAbs);
+    }
+
+    std::printf("%d of %d runs within tolerance\n", numRuns - numFailures, numRuns);
+    return numFailures == 0 ? 0 : 1;
+}
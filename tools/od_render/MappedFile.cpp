@@ -0,0 +1,126 @@
+# include "MappedFile.h"
+
+# ifdef _WIN32
+    # define WIN32_LEAN_AND_MEAN
+    # define NOMINMAX
+    # include <windows.h>
+# else
+    # include <fcntl.h>
+    # include <sys/mman.h>
+    # include <sys/stat.h>
+    # include <unistd.h>
+    # include <cerrno>
+    # include <cstring>
+# endif
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+# ifdef _WIN32
+
+bool MappedFile::open(const std::string& path)
+{
+    close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        errorMessage = "cannot open " + path;
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        errorMessage = "empty or unreadable file " + path;
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (view == nullptr)
+    {
+        if (mapping != nullptr)
+            CloseHandle(mapping);
+        CloseHandle(file);
+        errorMessage = "cannot map " + path;
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    bytes = static_cast<const unsigned char*>(view);
+    numBytes = static_cast<std::size_t>(fileSize.QuadPart);
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (bytes != nullptr)
+        UnmapViewOfFile(bytes);
+    if (mappingHandle != nullptr)
+        CloseHandle(mappingHandle);
+    if (fileHandle != nullptr)
+        CloseHandle(fileHandle);
+
+    bytes = nullptr;
+    numBytes = 0;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+}
+
+# else
+
+bool MappedFile::open(const std::string& path)
+{
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        errorMessage = "cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        ::close(fd);
+        errorMessage = "empty or unreadable file " + path;
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED)
+    {
+        ::close(fd);
+        errorMessage = "cannot map " + path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    // the renderer walks the file front to back exactly once
+    madvise(view, static_cast<std::size_t>(info.st_size), MADV_SEQUENTIAL);
+
+    fileDescriptor = fd;
+    bytes = static_cast<const unsigned char*>(view);
+    numBytes = static_cast<std::size_t>(info.st_size);
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (bytes != nullptr)
+        munmap(const_cast<unsigned char*>(bytes), numBytes);
+    if (fileDescriptor >= 0)
+        ::close(fileDescriptor);
+
+    bytes = nullptr;
+    numBytes = 0;
+    fileDescriptor = -1;
+}
+
+# endif
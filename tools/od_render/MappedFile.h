@@ -0,0 +1,37 @@
+# pragma once
+
+# include <cstddef>
+# include <string>
+
+// read-only memory mapping of a whole file
+class MappedFile
+{
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // map the file, returns false (with errorMessage set) on failure
+        bool open(const std::string& path);
+
+        // unmap and close
+        void close();
+
+        const unsigned char* data() const { return bytes; }
+        std::size_t size() const { return numBytes; }
+        const std::string& getErrorMessage() const { return errorMessage; }
+
+    private:
+        const unsigned char* bytes = nullptr;
+        std::size_t numBytes = 0;
+        std::string errorMessage;
+
+    # ifdef _WIN32
+        void* fileHandle = nullptr;
+        void* mappingHandle = nullptr;
+    # else
+        int fileDescriptor = -1;
+    # endif
+};
@@ -0,0 +1,277 @@
+# include "WavIO.h"
+
+# include <algorithm>
+# include <cstring>
+
+namespace
+{
+    std::uint16_t readU16(const unsigned char* p)
+    {
+        return static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+    }
+
+    std::uint32_t readU32(const unsigned char* p)
+    {
+        return static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8)
+             | (static_cast<std::uint32_t>(p[2]) << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+    }
+
+    void writeU16(unsigned char* p, std::uint16_t value)
+    {
+        p[0] = static_cast<unsigned char>(value & 0xff);
+        p[1] = static_cast<unsigned char>(value >> 8);
+    }
+
+    void writeU32(unsigned char* p, std::uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+            p[i] = static_cast<unsigned char>((value >> (8 * i)) & 0xff);
+    }
+
+    // decode one little-endian sample to [-1, 1]
+    float decodeSample(const unsigned char* p, SampleFormat format)
+    {
+        switch (format)
+        {
+            case SampleFormat::Int16:
+                return static_cast<float>(static_cast<std::int16_t>(readU16(p))) / 32768.0f;
+            case SampleFormat::Int24:
+            {
+                std::int32_t value = static_cast<std::int32_t>((p[0] << 8) | (p[1] << 16) | (static_cast<std::uint32_t>(p[2]) << 24)) >> 8;
+                return static_cast<float>(value) / 8388608.0f;
+            }
+            case SampleFormat::Int32:
+                return static_cast<float>(static_cast<std::int32_t>(readU32(p))) / 2147483648.0f;
+            case SampleFormat::Float32:
+            {
+                std::uint32_t bits = readU32(p);
+                float value;
+                std::memcpy(&value, &bits, sizeof(value));
+                return value;
+            }
+        }
+        return 0.0f;
+    }
+
+    constexpr std::size_t headerBytes = 44;
+}
+
+namespace WavIO
+{
+    int bytesPerSample(SampleFormat format)
+    {
+        switch (format)
+        {
+            case SampleFormat::Int16:   return 2;
+            case SampleFormat::Int24:   return 3;
+            case SampleFormat::Int32:   return 4;
+            case SampleFormat::Float32: return 4;
+        }
+        return 4;
+    }
+
+    bool parseWav(const unsigned char* bytes, std::size_t numBytes, AudioStream& stream, std::string& errorMessage)
+    {
+        if (numBytes < 12 || std::memcmp(bytes, "RIFF", 4) != 0 || std::memcmp(bytes + 8, "WAVE", 4) != 0)
+        {
+            errorMessage = "not a RIFF/WAVE file";
+            return false;
+        }
+
+        bool haveFormat = false;
+        std::uint16_t formatTag = 0;
+        std::uint16_t bitsPerSample = 0;
+        std::size_t position = 12;
+
+        // walk the chunk list until the data chunk
+        while (position + 8 <= numBytes)
+        {
+            const unsigned char* chunk = bytes + position;
+            std::size_t chunkSize = readU32(chunk + 4);
+            const unsigned char* body = chunk + 8;
+
+            if (std::memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16 && position + 8 + chunkSize <= numBytes)
+            {
+                formatTag = readU16(body);
+                stream.numChannels = readU16(body + 2);
+                stream.sampleRate = static_cast<float>(readU32(body + 4));
+                bitsPerSample = readU16(body + 14);
+
+                // WAVE_FORMAT_EXTENSIBLE keeps the real tag in the sub-format GUID
+                if (formatTag == 0xfffe && chunkSize >= 40)
+                    formatTag = readU16(body + 24);
+
+                haveFormat = true;
+            }
+            else if (std::memcmp(chunk, "data", 4) == 0)
+            {
+                if (!haveFormat)
+                {
+                    errorMessage = "data chunk before fmt chunk";
+                    return false;
+                }
+
+                if (formatTag == 1 && bitsPerSample == 16)
+                    stream.format = SampleFormat::Int16;
+                else if (formatTag == 1 && bitsPerSample == 24)
+                    stream.format = SampleFormat::Int24;
+                else if (formatTag == 1 && bitsPerSample == 32)
+                    stream.format = SampleFormat::Int32;
+                else if (formatTag == 3 && bitsPerSample == 32)
+                    stream.format = SampleFormat::Float32;
+                else
+                {
+                    errorMessage = "unsupported sample format (tag " + std::to_string(formatTag)
+                                 + ", " + std::to_string(bitsPerSample) + " bit)";
+                    return false;
+                }
+
+                if (stream.numChannels <= 0)
+                {
+                    errorMessage = "no channels";
+                    return false;
+                }
+
+                // everything downstream divides by the rate
+                if (!(stream.sampleRate > 0.0f))
+                {
+                    errorMessage = "invalid sample rate " + std::to_string(static_cast<long long>(stream.sampleRate));
+                    return false;
+                }
+
+                // tolerate truncated files, render what is actually there
+                std::size_t available = std::min(chunkSize, numBytes - (position + 8));
+                std::size_t frameBytes = static_cast<std::size_t>(stream.numChannels * bytesPerSample(stream.format));
+                stream.data = body;
+                stream.numFrames = available / frameBytes;
+                return true;
+            }
+
+            // chunks are word aligned
+            position += 8 + chunkSize + (chunkSize & 1);
+        }
+
+        errorMessage = "no data chunk";
+        return false;
+    }
+
+    AudioStream describeRaw(const unsigned char* bytes, std::size_t numBytes, int numChannels,
+                            float sampleRate, SampleFormat format)
+    {
+        AudioStream stream;
+        stream.data = bytes;
+        stream.numChannels = numChannels;
+        stream.sampleRate = sampleRate;
+        stream.format = format;
+        stream.numFrames = numBytes / static_cast<std::size_t>(numChannels * bytesPerSample(format));
+        return stream;
+    }
+
+    void readFrames(const AudioStream& stream, std::size_t startFrame, int numFrames, float* const* channels)
+    {
+        const int sampleBytes = bytesPerSample(stream.format);
+        const std::size_t frameBytes = static_cast<std::size_t>(stream.numChannels * sampleBytes);
+        const unsigned char* source = stream.data + startFrame * frameBytes;
+
+        for (int i = 0; i < numFrames; ++i)
+        {
+            for (int channel = 0; channel < stream.numChannels; ++channel)
+                channels[channel][i] = decodeSample(source + channel * sampleBytes, stream.format);
+
+            source += frameBytes;
+        }
+    }
+}
+
+WavWriter::~WavWriter()
+{
+    close();
+}
+
+bool WavWriter::fitsInHeader(std::uint64_t numFrames, int numChannels)
+{
+    // the RIFF size counts everything after its own field, header included
+    const std::uint64_t maxDataBytes = 0xffffffffull - (headerBytes - 8);
+    return numChannels > 0 && numChannels <= 0xffff
+        && numFrames <= maxDataBytes / (static_cast<std::uint64_t>(numChannels) * sizeof(float));
+}
+
+bool WavWriter::open(const std::string& path, int numChannels, float sampleRate)
+{
+    close();
+
+    file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+
+    channels = numChannels;
+    dataBytes = 0;
+    buffer.resize(bufferBytes);
+    bufferUsed = 0;
+
+    // IEEE float header, sizes are patched in close()
+    unsigned char header[headerBytes] = {};
+    std::memcpy(header, "RIFF", 4);
+    std::memcpy(header + 8, "WAVEfmt ", 8);
+    writeU32(header + 16, 16);
+    writeU16(header + 20, 3);
+    writeU16(header + 22, static_cast<std::uint16_t>(numChannels));
+    writeU32(header + 24, static_cast<std::uint32_t>(sampleRate));
+    writeU32(header + 28, static_cast<std::uint32_t>(sampleRate) * static_cast<std::uint32_t>(numChannels) * 4);
+    writeU16(header + 32, static_cast<std::uint16_t>(numChannels * 4));
+    writeU16(header + 34, 32);
+    std::memcpy(header + 36, "data", 4);
+
+    return std::fwrite(header, 1, headerBytes, file) == headerBytes;
+}
+
+bool WavWriter::write(const float* const* source, int numFrames)
+{
+    const std::size_t frameBytes = static_cast<std::size_t>(channels) * sizeof(float);
+    if (!fitsInHeader(dataBytes / frameBytes + static_cast<std::uint64_t>(numFrames), channels))
+        return false;
+
+    for (int i = 0; i < numFrames; ++i)
+    {
+        if (bufferUsed + frameBytes > buffer.size() && !flush())
+            return false;
+
+        for (int channel = 0; channel < channels; ++channel)
+        {
+            std::memcpy(buffer.data() + bufferUsed, &source[channel][i], sizeof(float));
+            bufferUsed += sizeof(float);
+        }
+    }
+
+    dataBytes += static_cast<std::uint64_t>(numFrames) * frameBytes;
+    return true;
+}
+
+bool WavWriter::flush()
+{
+    if (bufferUsed == 0)
+        return true;
+
+    bool ok = std::fwrite(buffer.data(), 1, bufferUsed, file) == bufferUsed;
+    bufferUsed = 0;
+    return ok;
+}
+
+bool WavWriter::close()
+{
+    if (file == nullptr)
+        return true;
+
+    bool ok = flush();
+
+    // patch RIFF and data sizes
+    unsigned char size[4];
+    writeU32(size, static_cast<std::uint32_t>(dataBytes + headerBytes - 8));
+    ok = ok && std::fseek(file, 4, SEEK_SET) == 0 && std::fwrite(size, 1, 4, file) == 4;
+    writeU32(size, static_cast<std::uint32_t>(dataBytes));
+    ok = ok && std::fseek(file, 40, SEEK_SET) == 0 && std::fwrite(size, 1, 4, file) == 4;
+
+    ok = std::fclose(file) == 0 && ok;
+    file = nullptr;
+    return ok;
+}
@@ -0,0 +1,73 @@
+# pragma once
+
+# include <cstddef>
+# include <cstdint>
+# include <cstdio>
+# include <string>
+# include <vector>
+
+// PCM sample encodings the renderer can read
+enum class SampleFormat
+{
+    Int16,
+    Int24,
+    Int32,
+    Float32
+};
+
+// interleaved little-endian PCM inside a mapped file
+struct AudioStream
+{
+    const unsigned char* data = nullptr;
+    std::size_t numFrames = 0;
+    int numChannels = 0;
+    float sampleRate = 0.0f;
+    SampleFormat format = SampleFormat::Float32;
+};
+
+namespace WavIO
+{
+    // bytes per sample of a format
+    int bytesPerSample(SampleFormat format);
+
+    // parse a RIFF/WAVE header, the stream points into the given bytes
+    bool parseWav(const unsigned char* bytes, std::size_t numBytes, AudioStream& stream, std::string& errorMessage);
+
+    // describe headerless interleaved PCM
+    AudioStream describeRaw(const unsigned char* bytes, std::size_t numBytes, int numChannels,
+                            float sampleRate, SampleFormat format);
+
+    // decode numFrames starting at startFrame into one float buffer per channel
+    void readFrames(const AudioStream& stream, std::size_t startFrame, int numFrames, float* const* channels);
+}
+
+// streams 32-bit float WAV through a large write buffer
+class WavWriter
+{
+    public:
+        ~WavWriter();
+
+        // true when numFrames of numChannels fit the 32-bit RIFF and data sizes,
+        // 4 GiB in all; the writer has no RF64 form and refuses anything larger
+        static bool fitsInHeader(std::uint64_t numFrames, int numChannels);
+
+        bool open(const std::string& path, int numChannels, float sampleRate);
+
+        // interleave and append numFrames from one buffer per channel,
+        // false once the file would outgrow fitsInHeader()
+        bool write(const float* const* channels, int numFrames);
+
+        // flush, patch the header sizes and close
+        bool close();
+
+    private:
+        static constexpr std::size_t bufferBytes = 1 << 20;
+
+        std::FILE* file = nullptr;
+        std::vector<unsigned char> buffer;
+        std::size_t bufferUsed = 0;
+        std::uint64_t dataBytes = 0;
+        int channels = 0;
+
+        bool flush();
+};
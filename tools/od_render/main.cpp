@@ -0,0 +1,450 @@
+// od_render: batch offline rendering of WAV/raw PCM files through OverdriveDSP
+//
+//   od_render [options] input.wav [more inputs...]
+//
+//   --drive <dB>          drive, 0..24 (default 0)
+//   --tone <Hz>           tone cutoff, 800..8000 (default 3000)
+//   --level <dB>          output level, -12..12 (default 0)
+//   --sample-rate <Hz>    sample rate of raw input (WAV files use their header)
+//   --raw <s16|s24|s32|f32> treat inputs as headerless little-endian PCM
+//   --channels <n>        channel count of raw input (default 1)
+//   --clipper <exact|pade|poly|lut|adaa1|adaa2>  saturator kernel (default exact)
+//   --filters <serial|lookahead>  mono filter structure (default lookahead, like the plugin)
+//   --cab <ir.wav>        convolve with a cabinet impulse response after the overdrive
+//   --block <n>           processing block size (default 512)
+//   --jobs <n>            worker threads (default: hardware concurrency)
+//   --output-dir <dir>    where to write results (default: next to the input)
+//   --trace <file.json>   record a Chrome/Perfetto timeline (ODPEDAL_TRACING builds)
+//
+// every output is a 32-bit float WAV named <input>_od.wav
+
+# include <algorithm>
+# include <atomic>
+# include <chrono>
+# include <cstdio>
+# include <cstdlib>
+# include <cstring>
+# include <filesystem>
+# include <mutex>
+# include <string>
+# include <thread>
+# include <vector>
+
+# include "CabinetSim.h"
+# include "OverdriveDSP.h"
+# include "TraceRecorder.h"
+# include "MappedFile.h"
+# include "WavIO.h"
+
+namespace
+{
+    struct RenderSettings
+    {
+        float drive = 0.0f;
+        float tone = 3000.0f;
+        float level = 0.0f;
+        float rawSampleRate = 48000.0f;
+        bool rawInput = false;
+        SampleFormat rawFormat = SampleFormat::Float32;
+        int rawChannels = 1;
+        SaturatorType saturator = SaturatorType::Exact;
+        FilterStructure filterStructure = FilterStructure::LookAhead;
+        int blockSize = 512;
+        int numJobs = 0;
+        std::string outputDir;
+        std::string tracePath;
+        std::vector<float> cabImpulse;   // mono, empty without --cab
+        float cabSampleRate = 0.0f;
+    };
+
+    struct RenderResult
+    {
+        bool ok = false;
+        std::string message;
+        double audioSeconds = 0.0;
+        double wallSeconds = 0.0;
+    };
+
+    void printUsage()
+    {
+        std::fprintf(stderr,
+            "usage: od_render [--drive dB] [--tone Hz] [--level dB] [--sample-rate Hz]\n"
+            "                 [--raw s16|s24|s32|f32] [--channels n] [--clipper exact|pade|poly|lut|adaa1|adaa2]\n"
+            "                 [--filters serial|lookahead] [--block n] [--jobs n] [--output-dir dir]\n"
+            "                 [--cab ir.wav] [--trace file.json] input...\n");
+    }
+
+    bool parseSaturator(const std::string& name, SaturatorType& type)
+    {
+        if (name == "exact") type = SaturatorType::Exact;
+        else if (name == "pade") type = SaturatorType::Pade;
+        else if (name == "poly") type = SaturatorType::Polynomial;
+        else if (name == "lut") type = SaturatorType::Lookup;
+        else if (name == "adaa1") type = SaturatorType::Adaa1;
+        else if (name == "adaa2") type = SaturatorType::Adaa2;
+        else return false;
+        return true;
+    }
+
+    bool parseFilterStructure(const std::string& name, FilterStructure& structure)
+    {
+        if (name == "serial") structure = FilterStructure::Serial;
+        else if (name == "lookahead") structure = FilterStructure::LookAhead;
+        else return false;
+        return true;
+    }
+
+    bool parseRawFormat(const std::string& name, SampleFormat& format)
+    {
+        if (name == "s16") format = SampleFormat::Int16;
+        else if (name == "s24") format = SampleFormat::Int24;
+        else if (name == "s32") format = SampleFormat::Int32;
+        else if (name == "f32") format = SampleFormat::Float32;
+        else return false;
+        return true;
+    }
+
+    // read a WAV impulse response, channels are averaged to mono
+    bool loadImpulseFile(const std::string& path, RenderSettings& settings, std::string& errorMessage)
+    {
+        MappedFile file;
+        if (!file.open(path))
+        {
+            errorMessage = file.getErrorMessage();
+            return false;
+        }
+
+        AudioStream stream;
+        if (!WavIO::parseWav(file.data(), file.size(), stream, errorMessage))
+            return false;
+
+        const int numFrames = static_cast<int>(stream.numFrames);
+        std::vector<std::vector<float>> channelData(static_cast<std::size_t>(stream.numChannels),
+                                                    std::vector<float>(stream.numFrames));
+        std::vector<float*> channelPtrs;
+        for (auto& channel : channelData)
+            channelPtrs.push_back(channel.data());
+        WavIO::readFrames(stream, 0, numFrames, channelPtrs.data());
+
+        settings.cabImpulse.assign(stream.numFrames, 0.0f);
+        for (const auto& channel : channelData)
+        {
+            for (int i = 0; i < numFrames; ++i)
+                settings.cabImpulse[static_cast<std::size_t>(i)] += channel[static_cast<std::size_t>(i)] / static_cast<float>(stream.numChannels);
+        }
+        settings.cabSampleRate = stream.sampleRate;
+        return true;
+    }
+
+    // <dir>/<stem>_od.wav, or next to the input when no directory is given
+    std::string makeOutputPath(const std::string& inputPath, const std::string& outputDir)
+    {
+        std::size_t slash = inputPath.find_last_of("/\\");
+        std::string directory = slash == std::string::npos ? std::string() : inputPath.substr(0, slash + 1);
+        std::string name = slash == std::string::npos ? inputPath : inputPath.substr(slash + 1);
+
+        std::size_t dot = name.find_last_of('.');
+        std::string stem = dot == std::string::npos ? name : name.substr(0, dot);
+
+        if (!outputDir.empty())
+            directory = outputDir + "/";
+
+        return directory + stem + "_od.wav";
+    }
+
+    // absolute and normalised, so two spellings of one file compare equal
+    std::filesystem::path comparablePath(const std::string& path)
+    {
+        std::error_code error;
+        std::filesystem::path canonical = std::filesystem::weakly_canonical(path, error);
+        return error ? std::filesystem::absolute(path, error).lexically_normal() : canonical;
+    }
+
+    RenderResult renderFile(const std::string& inputPath, const std::string& outputPath, const RenderSettings& settings)
+    {
+        RenderResult result;
+        auto startTime = std::chrono::steady_clock::now();
+
+        MappedFile input;
+        if (!input.open(inputPath))
+        {
+            result.message = input.getErrorMessage();
+            return result;
+        }
+
+        AudioStream stream;
+        if (settings.rawInput)
+        {
+            stream = WavIO::describeRaw(input.data(), input.size(), settings.rawChannels,
+                                        settings.rawSampleRate, settings.rawFormat);
+        }
+        else if (!WavIO::parseWav(input.data(), input.size(), stream, result.message))
+        {
+            return result;
+        }
+
+        // the output is only created once the input is known to render
+        if (!WavWriter::fitsInHeader(stream.numFrames, stream.numChannels))
+        {
+            result.message = "output would exceed the 4 GiB WAV size limit";
+            return result;
+        }
+
+        WavWriter writer;
+        if (!writer.open(outputPath, stream.numChannels, stream.sampleRate))
+        {
+            result.message = "cannot create " + outputPath;
+            return result;
+        }
+
+        // all buffers are allocated once per file, the block loop only streams
+        OverdriveDSP<float> dsp;
+        dsp.prepare(stream.sampleRate, stream.numChannels, settings.saturator);
+        dsp.setFilterStructure(settings.filterStructure);
+
+        CabinetSim<float> cabinet;
+        cabinet.prepare(stream.sampleRate, stream.numChannels);
+        cabinet.loadImpulse(settings.cabImpulse.data(), static_cast<int>(settings.cabImpulse.size()), settings.cabSampleRate);
+
+        std::vector<std::vector<float>> channelData(static_cast<std::size_t>(stream.numChannels),
+                                                    std::vector<float>(static_cast<std::size_t>(settings.blockSize)));
+        std::vector<float*> channelPtrs;
+        for (auto& channel : channelData)
+            channelPtrs.push_back(channel.data());
+
+        for (std::size_t frame = 0; frame < stream.numFrames; frame += static_cast<std::size_t>(settings.blockSize))
+        {
+            int numFrames = static_cast<int>(std::min<std::size_t>(static_cast<std::size_t>(settings.blockSize),
+                                                                   stream.numFrames - frame));
+
+            ODPEDAL_TRACE_SCOPE("block");
+            {
+                ODPEDAL_TRACE_SCOPE("read");
+                WavIO::readFrames(stream, frame, numFrames, channelPtrs.data());
+            }
+
+            dsp.process(channelPtrs.data(), stream.numChannels, numFrames, settings.drive, settings.tone, settings.level);
+            cabinet.processBlock(channelPtrs.data(), stream.numChannels, numFrames);
+
+            ODPEDAL_TRACE_SCOPE("write");
+            if (!writer.write(channelPtrs.data(), numFrames))
+            {
+                writer.close();
+                std::remove(outputPath.c_str());
+                result.message = "write failed for " + outputPath;
+                return result;
+            }
+        }
+
+        if (!writer.close())
+        {
+            std::remove(outputPath.c_str());
+            result.message = "write failed for " + outputPath;
+            return result;
+        }
+
+        result.ok = true;
+        result.message = outputPath;
+        result.audioSeconds = static_cast<double>(stream.numFrames) / stream.sampleRate;
+        result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        return result;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    RenderSettings settings;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        std::string value = hasValue ? argv[i + 1] : "";
+
+        if (arg == "--help" || arg == "-h")
+        {
+            printUsage();
+            return 0;
+        }
+
+        if (arg.rfind("--", 0) == 0 && !hasValue)
+        {
+            std::fprintf(stderr, "missing value for %s\n", arg.c_str());
+            return 1;
+        }
+
+        if (arg == "--drive") settings.drive = std::strtof(value.c_str(), nullptr);
+        else if (arg == "--tone") settings.tone = std::strtof(value.c_str(), nullptr);
+        else if (arg == "--level") settings.level = std::strtof(value.c_str(), nullptr);
+        else if (arg == "--sample-rate") settings.rawSampleRate = std::strtof(value.c_str(), nullptr);
+        else if (arg == "--channels") settings.rawChannels = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--block") settings.blockSize = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--jobs") settings.numJobs = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--output-dir") settings.outputDir = value;
+        else if (arg == "--trace") settings.tracePath = value;
+        else if (arg == "--raw")
+        {
+            settings.rawInput = true;
+            if (!parseRawFormat(value, settings.rawFormat))
+            {
+                std::fprintf(stderr, "unknown raw format %s\n", value.c_str());
+                return 1;
+            }
+        }
+        else if (arg == "--clipper")
+        {
+            if (!parseSaturator(value, settings.saturator))
+            {
+                std::fprintf(stderr, "unknown clipper %s\n", value.c_str());
+                return 1;
+            }
+        }
+        else if (arg == "--filters")
+        {
+            if (!parseFilterStructure(value, settings.filterStructure))
+            {
+                std::fprintf(stderr, "unknown filter structure %s\n", value.c_str());
+                return 1;
+            }
+        }
+        else if (arg == "--cab")
+        {
+            std::string errorMessage;
+            if (!loadImpulseFile(value, settings, errorMessage))
+            {
+                std::fprintf(stderr, "%s: %s\n", value.c_str(), errorMessage.c_str());
+                return 1;
+            }
+        }
+        else if (arg.rfind("--", 0) == 0)
+        {
+            std::fprintf(stderr, "unknown option %s\n", arg.c_str());
+            printUsage();
+            return 1;
+        }
+        else
+        {
+            inputs.push_back(arg);
+            continue;
+        }
+
+        ++i;
+    }
+
+    if (inputs.empty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    if (settings.rawInput && !(settings.rawSampleRate > 0.0f))
+    {
+        std::fprintf(stderr, "--sample-rate must be positive\n");
+        return 1;
+    }
+
+    // keep the parameters inside the plugin's ranges
+    settings.drive = std::clamp(settings.drive, 0.0f, 24.0f);
+    settings.tone = std::clamp(settings.tone, 800.0f, 8000.0f);
+    settings.level = std::clamp(settings.level, -12.0f, 12.0f);
+
+    // every output needs its own name, and none may replace an input still to be read
+    std::vector<std::string> outputs;
+    std::vector<std::filesystem::path> inputKeys;
+    std::vector<std::filesystem::path> outputKeys;
+    for (const std::string& input : inputs)
+    {
+        outputs.push_back(makeOutputPath(input, settings.outputDir));
+        inputKeys.push_back(comparablePath(input));
+        outputKeys.push_back(comparablePath(outputs.back()));
+    }
+
+    for (std::size_t i = 0; i < inputs.size(); ++i)
+    {
+        for (std::size_t j = 0; j < inputs.size(); ++j)
+        {
+            if (j < i && outputKeys[i] == outputKeys[j])
+            {
+                std::fprintf(stderr, "%s and %s would both write %s\n", inputs[j].c_str(), inputs[i].c_str(), outputs[i].c_str());
+                return 1;
+            }
+
+            if (outputKeys[i] == inputKeys[j])
+            {
+                std::fprintf(stderr, "%s would overwrite the input %s\n", inputs[i].c_str(), inputs[j].c_str());
+                return 1;
+            }
+        }
+    }
+
+    int numJobs = settings.numJobs > 0 ? settings.numJobs : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    numJobs = std::min(numJobs, static_cast<int>(inputs.size()));
+
+    // work queue: each worker claims the next unrendered file
+    std::atomic<std::size_t> nextInput { 0 };
+    std::atomic<int> failures { 0 };
+    std::atomic<long long> totalAudioMicros { 0 };
+    std::mutex printLock;
+
+    auto worker = [&]()
+    {
+        for (std::size_t index = nextInput++; index < inputs.size(); index = nextInput++)
+        {
+            RenderResult result = renderFile(inputs[index], outputs[index], settings);
+
+            std::lock_guard<std::mutex> lock(printLock);
+            if (result.ok)
+            {
+                totalAudioMicros += static_cast<long long>(result.audioSeconds * 1.0e6);
+                std::printf("%s -> %s  %.2f s audio in %.3f s (%.1fx realtime)\n",
+                            inputs[index].c_str(), result.message.c_str(), result.audioSeconds, result.wallSeconds,
+                            result.wallSeconds > 0.0 ? result.audioSeconds / result.wallSeconds : 0.0);
+            }
+            else
+            {
+                ++failures;
+                std::fprintf(stderr, "%s: %s\n", inputs[index].c_str(), result.message.c_str());
+            }
+        }
+    };
+
+    if (!settings.tracePath.empty())
+    {
+    # if defined(ODPEDAL_ENABLE_TRACING) && ODPEDAL_ENABLE_TRACING
+        if (!TraceRecorder::getInstance().start(settings.tracePath))
+        {
+            std::fprintf(stderr, "cannot create %s\n", settings.tracePath.c_str());
+            return 1;
+        }
+    # else
+        std::fprintf(stderr, "--trace needs a build configured with -DODPEDAL_TRACING=ON\n");
+        return 1;
+    # endif
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> pool;
+    for (int i = 0; i < numJobs; ++i)
+        pool.emplace_back(worker);
+    for (auto& thread : pool)
+        thread.join();
+
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    if (TraceRecorder::getInstance().isRecording())
+    {
+        TraceRecorder::getInstance().stop();
+        std::printf("trace written to %s (%llu events dropped)\n", settings.tracePath.c_str(),
+                    static_cast<unsigned long long>(TraceRecorder::getInstance().getDroppedEvents()));
+    }
+
+    double audioSeconds = static_cast<double>(totalAudioMicros.load()) * 1.0e-6;
+
+    std::printf("rendered %zu file(s) on %d thread(s): %.2f s audio in %.3f s (%.1fx realtime)\n",
+                inputs.size() - static_cast<std::size_t>(failures.load()), numJobs, audioSeconds, wallSeconds,
+                wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0);
+
+    return failures.load() == 0 ? 0 : 1;
+}
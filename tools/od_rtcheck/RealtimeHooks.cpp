@@ -0,0 +1,131 @@
+// replacements for the heap and blocking-lock entry points, linked into a test
+// executable so they take precedence over glibc's. each one reports to
+// RealtimeCheck when the calling thread is inside a realtime scope, then
+// forwards to the real implementation: glibc's __libc_* allocator entry
+// points, and the next definition of the pthread calls found through dlsym.
+// operator new and delete reach the allocator through malloc and free.
+
+# include <cerrno>
+# include <cstddef>
+
+# include <dlfcn.h>
+# include <pthread.h>
+# include <semaphore.h>
+
+# include "RealtimeCheck.h"
+
+extern "C"
+{
+    void* __libc_malloc(std::size_t size);
+    void* __libc_calloc(std::size_t count, std::size_t size);
+    void* __libc_realloc(void* pointer, std::size_t size);
+    void* __libc_memalign(std::size_t alignment, std::size_t size);
+    void __libc_free(void* pointer);
+}
+
+namespace
+{
+    void check(const char* operation)
+    {
+        if (RealtimeCheck::isActive())
+            RealtimeCheck::reportViolation(operation);
+    }
+
+    // the next definition of a symbol after this executable, resolved on first use
+    template <typename Function>
+    Function next(Function& cached, const char* name)
+    {
+        if (cached == nullptr)
+            cached = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+        return cached;
+    }
+
+    using MutexFunction = int (*)(pthread_mutex_t*);
+    using RwlockFunction = int (*)(pthread_rwlock_t*);
+    using SemaphoreFunction = int (*)(sem_t*);
+
+    MutexFunction realMutexLock = nullptr;
+    RwlockFunction realReadLock = nullptr;
+    RwlockFunction realWriteLock = nullptr;
+    SemaphoreFunction realSemaphoreWait = nullptr;
+}
+
+extern "C"
+{
+    void* malloc(std::size_t size)
+    {
+        check("malloc");
+        return __libc_malloc(size);
+    }
+
+    void* calloc(std::size_t count, std::size_t size)
+    {
+        check("calloc");
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* pointer, std::size_t size)
+    {
+        check("realloc");
+        return __libc_realloc(pointer, size);
+    }
+
+    void free(void* pointer)
+    {
+        if (pointer != nullptr)
+            check("free");
+        __libc_free(pointer);
+    }
+
+    void* memalign(std::size_t alignment, std::size_t size)
+    {
+        check("memalign");
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(std::size_t alignment, std::size_t size)
+    {
+        check("aligned_alloc");
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** result, std::size_t alignment, std::size_t size)
+    {
+        check("posix_memalign");
+        if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0)
+            return EINVAL;
+
+        void* pointer = __libc_memalign(alignment, size);
+        if (pointer == nullptr)
+            return ENOMEM;
+
+        *result = pointer;
+        return 0;
+    }
+
+    // std::mutex, std::shared_mutex and semaphores block through these;
+    // try-locks never wait and are left alone
+    int pthread_mutex_lock(pthread_mutex_t* mutex)
+    {
+        check("pthread_mutex_lock");
+        return next(realMutexLock, "pthread_mutex_lock")(mutex);
+    }
+
+    int pthread_rwlock_rdlock(pthread_rwlock_t* lock)
+    {
+        check("pthread_rwlock_rdlock");
+        return next(realReadLock, "pthread_rwlock_rdlock")(lock);
+    }
+
+    int pthread_rwlock_wrlock(pthread_rwlock_t* lock)
+    {
+        check("pthread_rwlock_wrlock");
+        return next(realWriteLock, "pthread_rwlock_wrlock")(lock);
+    }
+
+    int sem_wait(sem_t* semaphore)
+    {
+        check("sem_wait");
+        return next(realSemaphoreWait, "sem_wait")(semaphore);
+    }
+}
@@ -0,0 +1,334 @@
+// od_rtcheck: realtime-safety check of the processing paths, Linux only
+//
+//   od_rtcheck [--quick] [--verbose]
+//
+// runs OverdriveDSP and the plugin's chain (OverdriveDSP then CabinetSim) the
+// way the plugin does, in 256-sample sub-blocks of uneven host blocks with
+// automated parameters and silence gaps, for both sample types, several
+// channel counts and every clipper and filter structure. every processing call
+// is wrapped in a RealtimeCheck::Scope, and RealtimeHooks.cpp traps any heap
+// or blocking lock call made inside one. the cabinet runs while another thread
+// keeps loading impulses, which covers the lock-free handover. each violation
+// is printed with its call stack and the exit code is non-zero.
+//
+// a self test first checks that the hooks are live, so a build that lost them
+// cannot pass silently. configure with -DODPEDAL_RTCHECK=ON to also get the
+// DSP's own ODPEDAL_REALTIME_SCOPE names in the reports.
+
+# include <algorithm>
+# include <atomic>
+# include <cmath>
+# include <cstdio>
+# include <mutex>
+# include <random>
+# include <string>
+# include <thread>
+# include <vector>
+
+# include "CabinetSim.h"
+# include "OverdriveDSP.h"
+# include "PedalChain.h"
+# include "RealtimeCheck.h"
+
+namespace
+{
+    struct CheckSettings
+    {
+        bool quick = false;
+        bool verbose = false;
+    };
+
+    // the plugin's sub-block size and a spread of host block sizes around it
+    constexpr int subBlockSize = 256;
+    constexpr int hostBlockSizes[] = { 1, 37, 256, 480, 1024, 3000 };
+    constexpr int samplesPerRun = 1 << 15;
+
+    const char* saturatorName(SaturatorType type)
+    {
+        switch (type)
+        {
+            case SaturatorType::Exact:      return "exact";
+            case SaturatorType::Pade:       return "pade";
+            case SaturatorType::Polynomial: return "poly";
+            case SaturatorType::Lookup:     return "lut";
+            case SaturatorType::Adaa1:      return "adaa1";
+            case SaturatorType::Adaa2:      return "adaa2";
+        }
+        return "exact";
+    }
+
+    // guitar-level noise with a silent stretch in the middle, so the silence
+    // fast path and its wake-up run too
+    template <typename Sample>
+    std::vector<Sample> makeInput(int numSamples)
+    {
+        std::mt19937 generator(99);
+        std::uniform_real_distribution<float> distribution(-0.5f, 0.5f);
+        std::vector<Sample> input(static_cast<std::size_t>(numSamples));
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const bool silent = i >= numSamples / 3 && i < numSamples / 2;
+            input[static_cast<std::size_t>(i)] = silent ? Sample(0) : static_cast<Sample>(distribution(generator));
+        }
+        return input;
+    }
+
+    // feed samplesPerRun samples through process(channels, numChannels, numSamples, position)
+    // in uneven host blocks split into sub-blocks, every call inside a realtime scope
+    template <typename Sample, typename Process>
+    void runBlocks(int numChannels, const std::vector<Sample>& input, Process&& process)
+    {
+        std::vector<std::vector<Sample>> channelData(static_cast<std::size_t>(numChannels),
+                                                     std::vector<Sample>(static_cast<std::size_t>(samplesPerRun)));
+        for (auto& channel : channelData)
+            std::copy(input.begin(), input.end(), channel.begin());
+
+        std::vector<Sample*> subBlock(static_cast<std::size_t>(numChannels));
+
+        int position = 0;
+        for (int block = 0; position < samplesPerRun; ++block)
+        {
+            const int hostBlock = std::min(hostBlockSizes[block % std::size(hostBlockSizes)], samplesPerRun - position);
+
+            RealtimeCheck::Scope scope("od_rtcheck host block");
+            for (int start = 0; start < hostBlock; start += subBlockSize)
+            {
+                const int length = std::min(subBlockSize, hostBlock - start);
+                for (int c = 0; c < numChannels; ++c)
+                    subBlock[static_cast<std::size_t>(c)] = channelData[static_cast<std::size_t>(c)].data() + position + start;
+
+                process(subBlock.data(), numChannels, length, position + start);
+            }
+
+            position += hostBlock;
+        }
+    }
+
+    // parameters sweep slowly so the smoothers and the tone ramp keep moving
+    void automation(int position, float& drive, float& tone, float& level)
+    {
+        const float phase = static_cast<float>(position) * 1.0e-4f;
+        drive = 12.0f + 12.0f * std::sin(phase);
+        tone = 800.0f + 7200.0f * (0.5f + 0.5f * std::sin(1.7f * phase));
+        level = 6.0f * std::sin(0.6f * phase);
+    }
+
+    // synthetic cabinet impulse, decaying noise
+    std::vector<float> makeImpulse(int length, unsigned seed)
+    {
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+        std::vector<float> impulse(static_cast<std::size_t>(length));
+        for (int i = 0; i < length; ++i)
+            impulse[static_cast<std::size_t>(i)] = distribution(generator) * std::exp(-6.0f * static_cast<float>(i) / static_cast<float>(length));
+        return impulse;
+    }
+
+    struct Totals
+    {
+        int runs = 0;
+        int failures = 0;
+    };
+
+    // report one run and print its violations
+    void finishRun(const std::string& name, Totals& totals, const CheckSettings& settings)
+    {
+        const int violations = RealtimeCheck::getViolationCount();
+        ++totals.runs;
+
+        if (violations > 0)
+        {
+            ++totals.failures;
+            std::printf("FAIL %s  %d violation(s)\n", name.c_str(), violations);
+            std::fflush(stdout);
+            RealtimeCheck::printViolations(stdout);
+        }
+        else if (settings.verbose)
+        {
+            std::printf("ok   %s\n", name.c_str());
+        }
+
+        std::fflush(stdout);
+        RealtimeCheck::clearViolations();
+    }
+
+    // an allocation, a free and a lock inside a scope must all be caught
+    bool hooksAreLive()
+    {
+        std::mutex mutex;
+        {
+            RealtimeCheck::Scope scope("od_rtcheck self test");
+            std::vector<int>* allocated = new std::vector<int>(16, 1);
+            delete allocated;
+            std::lock_guard<std::mutex> lock(mutex);
+        }
+
+        const bool live = RealtimeCheck::getViolationCount() >= 3;
+        RealtimeCheck::clearViolations();
+        return live;
+    }
+
+    template <typename Sample>
+    void checkOverdrive(const CheckSettings& settings, Totals& totals, const char* typeName)
+    {
+        const std::vector<Sample> input = makeInput<Sample>(samplesPerRun);
+
+        std::vector<SaturatorType> saturators { SaturatorType::Exact, SaturatorType::Pade, SaturatorType::Polynomial,
+                                                SaturatorType::Lookup, SaturatorType::Adaa1, SaturatorType::Adaa2 };
+        std::vector<int> channelCounts { 1, 2, 5 };
+        if (settings.quick)
+        {
+            saturators = { SaturatorType::Lookup, SaturatorType::Adaa2 };
+            channelCounts = { 1, 2 };
+        }
+
+        for (SaturatorType saturator : saturators)
+        {
+            for (FilterStructure structure : { FilterStructure::Serial, FilterStructure::LookAhead })
+            {
+                for (int numChannels : channelCounts)
+                {
+                    OverdriveDSP<Sample> dsp;
+                    dsp.setFilterStructure(structure);
+                    dsp.prepare(48000.0f, numChannels, saturator);
+
+                    runBlocks(numChannels, input, [&](Sample* const* channels, int count, int length, int position)
+                    {
+                        float drive, tone, level;
+                        automation(position, drive, tone, level);
+                        dsp.setParameters(drive, tone, level);
+
+                        // the touch-sensitive mode for every other stretch
+                        const bool touch = (position / 8192) % 2 == 1;
+                        dsp.setEnvelopeModulation(touch ? 9.0f : 0.0f, touch ? 1.0f : 0.0f);
+                        dsp.processBlock(channels, count, length);
+                    });
+
+                    finishRun(std::string("overdrive ") + typeName + " " + saturatorName(saturator) + " "
+                              + (structure == FilterStructure::LookAhead ? "lookahead " : "serial ")
+                              + std::to_string(numChannels) + "ch", totals, settings);
+                }
+            }
+        }
+    }
+
+    // the plugin's chain with the cabinet switched on and off and reset after
+    // a bypass, program changes and the touch-sensitive mode switching, while
+    // another thread keeps loading new impulses
+    template <typename Sample>
+    void checkChain(const CheckSettings& settings, Totals& totals, const char* typeName)
+    {
+        using Chain = PedalChain<OverdriveDSP<Sample>, CabinetSim<Sample>>;
+        const std::vector<Sample> input = makeInput<Sample>(samplesPerRun);
+
+        for (int numChannels : { 1, 2 })
+        {
+            Chain chain;
+            auto& overdrive = chain.template get<OverdriveDSP<Sample>>();
+            auto& cabinet = chain.template get<CabinetSim<Sample>>();
+
+            // an impulse loaded before prepare() is built by it, like a restored session
+            const std::vector<float> firstImpulse = makeImpulse(9000, 1);
+            cabinet.loadImpulse(firstImpulse.data(), static_cast<int>(firstImpulse.size()), 44100.0f);
+            overdrive.setFilterStructure(FilterStructure::LookAhead);
+            chain.prepare(48000.0f, numChannels);
+
+            // program snapshots are built off the audio thread, like ProgramBank does
+            const typename OverdriveDSP<Sample>::Snapshot programs[] = { overdrive.makeSnapshot(2.0f, 5000.0f, 6.0f),
+                                                                         overdrive.makeSnapshot(20.0f, 2400.0f, -2.0f) };
+            int nextProgramChange = 1000;
+
+            std::atomic<bool> loading { true };
+            std::thread loader([&]()
+            {
+                for (unsigned seed = 2; loading.load(std::memory_order_relaxed); ++seed)
+                {
+                    const std::vector<float> impulse = makeImpulse(settings.quick ? 4000 : 30000 + static_cast<int>(seed % 7) * 3000, seed);
+                    cabinet.loadImpulse(impulse.data(), static_cast<int>(impulse.size()), seed % 2 == 0 ? 48000.0f : 96000.0f);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            });
+
+            runBlocks(numChannels, input, [&](Sample* const* channels, int count, int length, int position)
+            {
+                // bypassed for one stretch, the cabinet restarts clean afterwards
+                const int stretch = position / 4096;
+                if (stretch == 3)
+                    return;
+                if (stretch == 4 && position % 4096 == 0)
+                    cabinet.reset();
+
+                // a program change every few thousand samples, crossfaded by the overdrive
+                if (position >= nextProgramChange)
+                {
+                    overdrive.applySnapshot(programs[(nextProgramChange / 5000) % 2]);
+                    nextProgramChange += 5000;
+                }
+
+                float drive, tone, level;
+                automation(position, drive, tone, level);
+                overdrive.setParameters(drive, tone, level);
+                overdrive.setEnvelopeModulation(stretch % 2 == 0 ? 9.0f : 0.0f, stretch % 2 == 0 ? 1.0f : 0.0f);
+                cabinet.setEnabled(stretch != 5);
+                chain.processBlock(channels, count, length);
+            });
+
+            loading.store(false, std::memory_order_relaxed);
+            loader.join();
+
+            finishRun(std::string("chain ") + typeName + " " + std::to_string(numChannels) + "ch", totals, settings);
+        }
+    }
+
+    void printUsage()
+    {
+        std::fprintf(stderr, "usage: od_rtcheck [--quick] [--verbose]\n");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    CheckSettings settings;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--quick")
+        {
+            settings.quick = true;
+        }
+        else if (arg == "--verbose")
+        {
+            settings.verbose = true;
+        }
+        else if (arg == "--help" || arg == "-h")
+        {
+            printUsage();
+            return 0;
+        }
+        else
+        {
+            std::fprintf(stderr, "unknown option %s\n", arg.c_str());
+            printUsage();
+            return 1;
+        }
+    }
+
+    RealtimeCheck::prepare();
+    Saturators::prepareLookupTable();
+
+    if (!hooksAreLive())
+    {
+        std::fprintf(stderr, "the allocation and lock hooks are not active, nothing would be caught\n");
+        return 1;
+    }
+
+    Totals totals;
+    checkOverdrive<float>(settings, totals, "float");
+    checkOverdrive<double>(settings, totals, "double");
+    checkChain<float>(settings, totals, "float");
+    checkChain<double>(settings, totals, "double");
+
+    std::printf("%d of %d runs realtime-safe\n", totals.runs - totals.failures, totals.runs);
+    return totals.failures == 0 ? 0 : 1;
+}